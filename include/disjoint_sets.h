@@ -0,0 +1,42 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// Union-find over the ids 0..size-1 with path halving and union by size, so
+// find and unite take amortized near constant time
+class DisjointSets {
+ public:
+  explicit DisjointSets(int size = 0) { reset(size); }
+
+  // Makes every id a singleton set
+  void reset(int size) {
+    parent_.resize(size);
+    size_.assign(size, 1);
+    for (int i = 0; i < size; i++) parent_[i] = i;
+  }
+
+  // Representative of the set containing x
+  int find(int x) {
+    while (parent_[x] != x) {
+      parent_[x] = parent_[parent_[x]];
+      x = parent_[x];
+    }
+    return x;
+  }
+
+  // Merges the sets containing a and b and returns the new representative
+  int unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return a;
+    if (size_[a] < size_[b]) std::swap(a, b);
+    parent_[b] = a;
+    size_[a] += size_[b];
+    return a;
+  }
+
+ private:
+  std::vector<int> parent_;
+  std::vector<int> size_;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "linear_function.h"
+
+// Edge functions of GrowSubsets stored as parallel arrays, so the per event
+// update and search run over contiguous memory and can be vectorized. The
+// endpoints are subset indices into a per subset flag array.
+struct EdgeArrays {
+  std::vector<double> first_minus;
+  std::vector<double> first_plus;
+  std::vector<double> second_minus;
+  std::vector<double> second_plus;
+  std::vector<double> tight_time;  // INT_MAX if the edge cannot go tight
+  std::vector<int32_t> p1;
+  std::vector<int32_t> p2;
+  std::vector<int32_t> edges;  // positions in the graph view
+
+  size_t size() const { return edges.size(); }
+
+  void push_back(int32_t edge, const LinearFunction& first,
+                 const LinearFunction& second, int32_t s1, int32_t s2);
+
+  // Copies edge from over edge to
+  void move(size_t from, size_t to);
+
+  void resize(size_t size);
+};
+
+// Bits of the per subset flag array
+enum SubsetFlags : uint8_t {
+  kSubsetActive = 1,
+  kSubsetTied = 2,
+};
+
+// Dual growth of one event: lin_val_, lin_val_p1_ and lin_val_p1_plus_p2_
+struct DualGrowth {
+  LinearFunction first;
+  LinearFunction p1;
+  LinearFunction p1_plus_p2;
+};
+
+// Subsets changed by one event. The flags of merged must already be set.
+struct SubsetChange {
+  int32_t neutral = -1;  // goes neutral after the update
+  int32_t s1 = -1;       // s1 and s2 are replaced by merged
+  int32_t s2 = -1;
+  int32_t merged = -1;
+};
+
+// Subtracts the dual growth from edges [begin, end) like
+// GrowSubsets::updateEdge, applies the change to the endpoints and stores the
+// time until each edge goes tight at lambda*(1-tieeps). With zero growth and
+// no change this only computes the tight times. If removed is given, the
+// indices of edges inside one subset are appended to it.
+void updateEdgeArrays(const DualGrowth& growth, const uint8_t* flags,
+                      const SubsetChange& change, size_t begin, size_t end,
+                      EdgeArrays* arrays,
+                      std::vector<size_t>* removed = nullptr);
+
+// (from, to) moves which remove the given edges (sorted) the same way
+// GrowSubsets::updateEdgesGivenTightEdge does: every removed edge is
+// overwritten by the last edge, so the order of the remaining edges matches.
+// The moves are independent of each other and leave the remaining edges in
+// the first size() - removed.size() slots.
+std::vector<std::pair<size_t, size_t>> removalMoves(
+    const EdgeArrays& arrays, const std::vector<size_t>& removed);
+
+// Finds the edge in [begin, end) with the smallest tight time, or
+// (INT_MAX, -1) if there is none. Edges are visited in order and one wins if
+// it is more than eps below the current best, like GrowSubsets::minEdgeTime.
+// The search can be continued over the next range by passing the result as
+// best.
+std::pair<double, int> minEdgeArrays(
+    const EdgeArrays& arrays, double eps, size_t begin, size_t end,
+    std::pair<double, int> best = std::make_pair(INT_MAX, -1));
+
+// Smallest tight time in [begin, end) without tie breaking, or INT_MAX
+double minTightTime(const EdgeArrays& arrays, size_t begin, size_t end);
@@ -10,13 +10,19 @@
 
 #pragma once
 
+#include <atomic>
 #include <climits>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
+#include "vertex_range.h"
+
 /* -------------------------EDGE--------------------------*/
 
 class Edge {
@@ -24,6 +30,9 @@ class Edge {
   int head;       // head vertex id
   int tail;       // tail vertex id
   double weight;  // weight of edge
+  int index;      // position in the edges of its graph, -1 if not in one
+
+  friend class Graph;
 
  public:
   // Constructors and Destructors
@@ -34,6 +43,7 @@ class Edge {
   int getHead() const { return head; }
   int getTail() const { return tail; }
   double getWeight() const { return weight; }
+  int getIndex() const { return index; }
   void setWeight(double w) { weight = w; }
   int getOther(int id);
 
@@ -46,12 +56,23 @@ class Edge {
 
 /* -------------------------VERTEX--------------------------*/
 
+class Graph;
+
+// A vertex on its own keeps a list of the edges added to it. A graph keeps the
+// edges of its vertices in its adjacency arrays instead, and only lists them
+// for a vertex when getIncEdges is called, after which the graph keeps the
+// list up to date.
 class Vertex {
  private:
-  int id;                                      // id
-  int prize;                                   // prize value
-  std::list<std::shared_ptr<Edge>> neighbors;  // list of incident edge pointers
-  double degree;  // sum of weights for incident edges
+  int id;     // id
+  int prize;  // prize value
+  mutable std::list<std::shared_ptr<Edge>> neighbors;  // list of incident
+                                                       // edge pointers
+  double degree;                 // sum of weights for incident edges
+  const Graph *graph = nullptr;  // graph the vertex is in, or nullptr
+  mutable bool listed = false;   // neighbors made by graph
+
+  friend class Graph;
 
  public:
   // Constructors and Destructors
@@ -62,9 +83,7 @@ class Vertex {
   // Get Functions
   int getId() const { return id; }
   int getPrize() const { return prize; }
-  std::list<std::shared_ptr<Edge>> const &getIncEdges() const {
-    return neighbors;
-  }
+  std::list<std::shared_ptr<Edge>> const &getIncEdges() const;
   double getDegree() const { return degree; }
 
   // Add and Remove Edges
@@ -74,17 +93,80 @@ class Vertex {
 
 /* -------------------------GRAPH--------------------------*/
 
+// Edge of a graph by the indices of its ends
+struct EdgeRecord {
+  uint32_t head;  // index of head vertex
+  uint32_t tail;  // index of tail vertex
+  double weight;  // weight of edge
+};
+
+// Edges at every vertex of a graph in compressed sparse row form. The edges at
+// the vertex with index i are edges[offsets[i]] up to edges[offsets[i + 1]],
+// by index and in the order they were added. A loop is there twice.
+struct Adjacency {
+  std::vector<uint32_t> offsets;  // start of the edges of each vertex
+  std::vector<uint32_t> edges;    // edge indices
+};
+
+// Coordinates of the vertices of a complete Euclidean graph, by vertex id
+struct Coordinates {
+  std::vector<int> x;
+  std::vector<int> y;
+
+  bool has(int i) const { return (i >= 0) && (i < static_cast<int>(x.size())); }
+  double distance(int i, int j) const {
+    int dx = x[i] - x[j], dy = y[i] - y[j];
+    return std::sqrt(dx * dx + dy * dy);
+  }
+};
+
+// Vertices and edges are numbered 0, 1, ... in the order they were added, and
+// the algorithms work on these indices and the flat arrays below. Vertex ids
+// and the Vertex and Edge objects are kept for callers.
 class Graph {
  private:
-  std::unordered_map<int, std::shared_ptr<Vertex>>
-      vertex_map;            // unordered_map of vertex ids to vertex data structures
-  std::list<int> vertices;  // list of vertex ids
-  std::list<std::shared_ptr<Edge>> edges;  // list of edge pointers
-  double W;                                // total weight of edges
-  int P;                                   // sum of prizes of vertices
+  std::vector<int> vertices;                         // vertex ids by index
+  std::unordered_map<int, int> vertex_index;         // index of each vertex id
+  std::vector<std::shared_ptr<Vertex>> vertex_data;  // vertices by index
+  mutable std::vector<EdgeRecord> edge_records;      // edges by index
+  mutable std::vector<std::shared_ptr<Edge>> edges;  // edge pointers by index
+  mutable std::shared_ptr<const Adjacency> adjacency;  // made on first use
+  std::shared_ptr<const Coordinates> coordinates;  // of a Euclidean graph
+  mutable std::atomic<bool> edges_made;  // records of a Euclidean graph are
+  mutable std::mutex edges_mutex;        // made on first use, and each Edge
+  mutable std::atomic<bool> edge_ptrs_made;  // object when it is asked for
+  mutable std::list<int> vertex_list;    // lists of the old API, made on
+  mutable std::list<std::shared_ptr<Edge>> edge_list;  // first use and then
+  mutable bool vertices_listed, edges_listed;          // kept up to date
+  mutable std::mutex lists_mutex;
+  double W;  // total weight of edges
+  int P;     // sum of prizes of vertices
+
+  // Used internally for the edges of a Euclidean graph
+  void makeEdges() const;
+  void makeEdgePtrs() const;
+  void needEdges() const {
+    if ((coordinates != nullptr) && !edges_made.load()) {
+      makeEdges();
+    }
+  }
+  void needEdgePtrs() const {
+    if ((coordinates != nullptr) && !edge_ptrs_made.load()) {
+      makeEdgePtrs();
+    }
+  }
+  void dropCoordinates();
+
+  // Used internally for the lists of the old API
+  std::shared_ptr<Vertex> makeVertex(int id, int prize);
+  void listEdges(const Vertex &v) const;
+  void unlist();
+
+  friend class Vertex;
 
-  // Used internally for removing vertices
-  void removeVertexLists(int id);
+  // Used internally for building subgraphs
+  template <typename Vertices>
+  void addSubgraph(const Graph &G, const Vertices &S);
 
  public:
   // Constructors and Destructors
@@ -92,14 +174,45 @@ class Graph {
   ~Graph();
   Graph(const Graph &G);                           // copy constructor
   Graph(const Graph &G, const std::list<int> &S);  // subgraph G(S)
+  Graph(const Graph &G, const VertexRange &S);     // subgraph G(S)
 
   // Get Functions
+  // The vertex and edge lists are made on first use and then kept up to date,
+  // see getVertexIds and getEdgePtrs for the arrays
   double getWeight() const { return W; }
   int getPrize() const { return P; }
-  std::list<int> const &getVertices() const { return vertices; }
-  std::list<std::shared_ptr<Edge>> const &getEdges() const { return edges; }
+  std::list<int> const &getVertices() const;
+  std::list<std::shared_ptr<Edge>> const &getEdges() const;
   std::shared_ptr<Vertex> const &getVertex(int i) const;
+  bool hasVertex(int i) const { return findIndex(i) >= 0; }
+  int getVertexPrize(int i) const { return getVertex(i)->getPrize(); }
   double getVertexDegree(int it) const;
+  std::vector<std::shared_ptr<Edge>> getIncEdges(int i) const;
+
+  // Get Functions by index
+  std::vector<int> const &getVertexIds() const { return vertices; }
+  std::vector<std::shared_ptr<Edge>> const &getEdgePtrs() const {
+    needEdgePtrs();
+    return edges;
+  }
+  std::shared_ptr<Edge> getEdgePtr(int k) const;  // edge with index k
+  int findIndex(int i) const;  // index of vertex id i, or -1
+  int getIndex(int i) const;   // index of vertex id i
+  std::vector<EdgeRecord> const &getEdgeRecords() const {
+    needEdges();
+    return edge_records;
+  }
+  const Adjacency &getAdjacency() const;
+
+  // Complete Euclidean graphs
+  // The graph has an edge between every two vertices with coordinates, and a
+  // loop at each, like the graphs read_file builds from node coordinates, but
+  // the edges are only made when something asks for them. The edge records
+  // are made together, and each Edge object when getEdgePtr asks for it, so
+  // the solver only makes those of the edges it returns. MST and tour length
+  // work from the coordinates.
+  void setCoordinates(std::vector<int> x, std::vector<int> y);
+  const Coordinates *getCoordinates() const { return coordinates.get(); }
 
   // Add and Remove Functions
   void addVertex(int id);
@@ -115,15 +228,21 @@ class Graph {
   double MST(std::list<std::shared_ptr<Edge>> &edges) const;
 };
 
-// Calculate tour length
+// Calculate tour length, see ShortestPaths to measure many tours of one graph
 double getTourLength(const Graph &G, const std::vector<int> &tour);
 
 // DFS
-void DFS(std::list<std::shared_ptr<Edge>> &edges, std::unordered_map<int, bool> &visited,
-         std::list<int> &tour, int v);
-
-// Find ordered list of tour given a tree of edges
-std::vector<int> tourList(std::list<std::shared_ptr<Edge>> &edges);
-
-// Find length of shortest path from i to j in G
+// Adds the ids of the vertices reached from vertex index v to tour in
+// preorder and marks them visited. Takes the edges at each vertex in the order
+// of adj, with the indices of their ends in records and vertex ids by index
+// in ids.
+void DFS(const Adjacency &adj, const std::vector<EdgeRecord> &records,
+         const std::vector<int> &ids, std::vector<char> &visited,
+         std::vector<int> &tour, int v);
+
+// Find ordered list of tour given a tree of edges, or of the trees of a forest
+// one after the other. Linear in the number of edges.
+std::vector<int> tourList(const std::list<std::shared_ptr<Edge>> &edges);
+
+// Find length of shortest path from i to j in G, INT_MAX if there is none
 double shortestPath(const Graph &G, int i, int j);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+#include "vertex_range.h"
+
+// Edges from each vertex of a view to its k nearest neighbors, to the ones as
+// near as the last of them, and of a minimum spanning tree, with the edges at
+// each vertex. Edges whose weight is not a number come last and are left out.
+struct NearestEdges {
+  int k;
+  std::vector<char> kept;                 // by index in getEdgePtrs()
+  std::vector<std::pair<int, int>> ends;  // positions of the ends of each edge
+  std::vector<int> offsets;   // edges at each position as offsets into
+  std::vector<int> incident;  // incident, self loops left out
+};
+
+// Read only view of a graph, or of the subgraph G(S) induced by some of its
+// vertices. A view of G(S) has the vertices in the order of S and the edges
+// in the order of G, like Graph(G, S), but shares the edges of G instead of
+// copying them. Setting one up allocates no edges and reads no more than the
+// edges at the vertices of S. The edges at positions 0 to getEdgeCount() - 1
+// can be read by their index in G without making their Edge objects. A view
+// must not outlive the graph it looks at.
+class GraphView {
+ private:
+  const Graph *graph;  // graph all views of it point to
+  bool whole;          // true if this is all of graph
+  std::vector<int> vertices;                 // vertices of a subgraph view
+  std::vector<uint32_t> edge_indices;  // index in graph of each edge of a
+                                       // subgraph view
+  mutable std::shared_ptr<const std::vector<std::shared_ptr<Edge>>>
+      edges;  // edges of a subgraph view, made on first use
+  std::vector<int> indices;    // index in graph of each vertex of the view
+  std::vector<int> positions;  // position in the view of each vertex of
+                               // graph, or -1
+  double W;                    // total weight of edges
+  int P;                       // sum of prizes of vertices
+  mutable std::shared_ptr<const NearestEdges> nearest;  // made on first use
+
+  // Used internally for building subgraph views
+  template <typename Vertices>
+  void addSubgraph(const Vertices &S);
+
+  // Used internally for the MST of a graph with few edges, and of a Euclidean
+  // graph
+  double sparseMST(std::list<std::shared_ptr<Edge>> &edges) const;
+  double euclideanMST(std::list<std::shared_ptr<Edge>> &edges) const;
+
+  // Edges at each position of the view, by index in graph and in the order of
+  // the adjacency of graph, for the MST. Those of a subgraph view are made in
+  // local from its own edges, leaving out self loops.
+  const Adjacency &positionAdjacency(Adjacency *local) const;
+
+ public:
+  // Constructors
+  GraphView(const Graph &G);  // all of G, so a Graph can be used as a view
+  GraphView(const GraphView &G, const std::list<int> &S);  // subgraph G(S)
+  GraphView(const GraphView &G, const VertexRange &S);     // subgraph G(S)
+
+  // Get Functions
+  const Graph &getGraph() const { return *graph; }
+  double getWeight() const { return W; }
+  int getPrize() const { return P; }
+  std::vector<int> const &getVertexIds() const {
+    return whole ? graph->getVertexIds() : vertices;
+  }
+  std::vector<std::shared_ptr<Edge>> const &getEdgePtrs() const;
+  size_t getEdgeCount() const {
+    return whole ? graph->getEdgeRecords().size() : edge_indices.size();
+  }
+  int getEdgeIndex(int k) const { return whole ? k : edge_indices[k]; }
+  std::shared_ptr<Edge> getEdgePtr(int k) const {
+    return graph->getEdgePtr(getEdgeIndex(k));
+  }
+  const EdgeRecord &getEdgeRecord(int k) const {
+    return graph->getEdgeRecords()[getEdgeIndex(k)];
+  }
+  bool hasVertex(int id) const;
+  int getVertexPrize(int id) const { return graph->getVertexPrize(id); }
+
+  // Index in graph of the vertex at a position of the view, and back (-1 if
+  // the vertex is not in the view)
+  int getIndex(int position) const {
+    return whole ? position : indices[position];
+  }
+  int getPosition(int index) const {
+    return whole ? index : positions[index];
+  }
+
+  // Minimum spanning tree
+  // Returns weight and tree is saved to edges. Prim's algorithm finds the next
+  // vertex by a scan on dense graphs and with a heap on sparse ones, which
+  // gives the same tree. On a Euclidean graph it works from the coordinates
+  // and the tree is made of new edges, equal to the ones of the graph.
+  double MST(std::list<std::shared_ptr<Edge>> &edges) const;
+
+  // Nearest edges with k neighbors. They are kept for the last k asked for, so
+  // the probes of one search share them. Safe to call from several threads.
+  std::shared_ptr<const NearestEdges> getNearestEdges(int k) const;
+};
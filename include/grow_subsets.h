@@ -1,12 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <list>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 
-#include "graph.h"
+#include "disjoint_sets.h"
+#include "edge_arrays.h"
+#include "graph_view.h"
+#include "growth_log.h"
+#include "indexed_heap.h"
 #include "linear_function.h"
+#include "problem.h"
+#include "subset_arena.h"
+#include "thread_pool.h"
 
 // Grow Function
 // Runs the PD subroutine with lambda_1 = lambda and returns the end subsets
@@ -15,50 +24,372 @@ class GrowSubsets {
  public:
   GrowSubsets(double tieeps = 0.001, double eps = 1.0e-15)
       : tieeps_(tieeps), eps_(eps) {}
+  explicit GrowSubsets(const SolverOptions& options, double tieeps = 0.001,
+                       double eps = 1.0e-15)
+      : tieeps_(tieeps),
+        eps_(eps),
+        engine_(options.growth_engine),
+        pool_(options.num_threads > 1 ? &ThreadPool::shared(options.num_threads)
+                                      : nullptr),
+        neighbors_(options.nearest_neighbors) {}
 
-  std::list<std::shared_ptr<Subset>> build(const Graph& G, double lambda);
+  std::list<std::shared_ptr<Subset>> build(const GraphView& G, double lambda);
+
+  // build which also records its events in log. If log holds the events of an
+  // earlier build on G, the leading ones which are the same at lambda are
+  // replayed without searching for them. Ranges are only tracked within
+  // [lo, hi], which contains lambda, and recording stops once an event only
+  // holds at lambda. Only kEdgeScan records events, the other engines leave log
+  // empty.
+  std::list<std::shared_ptr<Subset>> build(const GraphView& G, double lambda,
+                                           GrowthLog* log, double lo,
+                                           double hi);
 
  private:
+  // Reference engine: every event rescans all edges and subsets. Also runs
+  // kContractedEdgeScan.
+  std::list<std::shared_ptr<Subset>> buildEdgeScan(const GraphView& G,
+                                                   double lambda);
+
+  // kEdgeScan over the edges to the neighbors_ nearest vertices of each
+  // vertex, repeated with the dropped edges it missed until there are none
+  std::list<std::shared_ptr<Subset>> buildSparse(const GraphView& G,
+                                                 double lambda);
+
+  // Reference engine over EdgeArrays with vectorized update and search
+  std::list<std::shared_ptr<Subset>> buildVectorScan(const GraphView& G,
+                                                     double lambda);
+
+  // Engines which keep dual offsets per component instead of updating every
+  // edge. kEventQueue finds events with heaps, kLazyEdgeScan by scanning.
+  std::list<std::shared_ptr<Subset>> buildLazyDuals(const GraphView& G,
+                                                    double lambda);
+
   // Linear search to find the minimum time until a set goes tight
-  std::pair<double, std::shared_ptr<Subset>> minSetTime() const;
+  std::pair<double, Subset*> minSetTime() const;
+
+  // Set of dense vertex v, or of the vertices of subset s, in the edge scan
+  int setOf(int v);
+  int setOf(Subset* s);
+
+  // Copies the activity and tie state of s into set_flags_
+  void refreshSetFlags(Subset* s);
+
+  // Copy of edge_functions_[i] with its endpoints' current subsets
+  EdgeFunctions scanEdgeFunctions(size_t i);
+
+  // New subset uniting S1 and S2 over edge e of graph_, with alt edge alt_e_.
+  // These are the only edges of the view the engines make Edge objects for.
+  Subset* mergeSubsets(Subset* S1, Subset* S2, int e);
+
+  // Roots of the family, shared with the caller of build()
+  std::list<std::shared_ptr<Subset>> shareRoots() const;
 
   // Linear search to find the minimum time until an edge goes tight
-  std::pair<double, EdgeFunctions> minEdgeTime() const;
+  std::pair<double, EdgeFunctions> minEdgeTime();
 
-  // Resolves ties between events. Modifies lin_val* containers and may mark
-  // some sets tied
-  void resolveTies(const EdgeFunctions& min_e_functions);
+  // Linear search for the edge between the parents of min_e_functions which is
+  // cheapest at lambda*(1+tieeps). Returns nullptr if min_e_functions is.
+  const EdgeFunctions* minTiedEdge(const EdgeFunctions& min_e_functions);
 
-  // Updates functions attached to each edge.
+  // Resolves ties between events given the cheapest edge between the same
+  // subsets at lambda*(1+tieeps) and the second linear functions of both
+  // subsets. Modifies lin_val* containers and may mark some sets tied
+  void resolveTies(const EdgeFunctions& min_e_functions,
+                   const EdgeFunctions* alt_e_functions,
+                   const LinearFunction& p1_second,
+                   const LinearFunction& p2_second);
+
+  // Updates functions attached to each edge given the SubsetFlags of its
+  // endpoints.
   // NOTE: this is the bottleneck (~40% of runtime)
-  void updateEdge(EdgeFunctions* edge);
+  void updateEdge(EdgeFunctions* edge, uint8_t p1_flags, uint8_t p2_flags);
 
   // Updates edges given that a subset goes neutral first.
   // NOTE: ~25% of runtime on small problems is spent in the body of this
   // function.
-  std::pair<double, EdgeFunctions> updateEdgesGivenNeutralSubset(
-      const std::shared_ptr<Subset>& min_s);
+  std::pair<double, EdgeFunctions> updateEdgesGivenNeutralSubset(Subset* min_s);
 
-  // Updates edges given that an edge goes tight first.
+  // Updates edges given that an edge goes tight first and unites S1 and S2.
   // NOTE: ~25% of runtime for small problems, 40% for large problems is spent
   // in the body of this function.
   std::pair<double, EdgeFunctions> updateEdgesGivenTightEdge(
-      const std::shared_ptr<Subset>& S1, const std::shared_ptr<Subset>& S2,
-      const std::shared_ptr<Subset>& S);
+      Subset* S1, Subset* S2, Subset* S);
 
   void updateSubsets();
 
+  // Slope in lambda of f at lambda*(1-tieeps) and at lambda*(1+tieeps)
+  double minusSlope(const LinearFunction& f) const {
+    return (f.t_plus - f.t_minus) * minus_slope_;
+  }
+  double plusSlope(const LinearFunction& f) const {
+    return (f.t_plus - f.t_minus) * plus_slope_;
+  }
+
+  // Narrows the lambda range of the events so far to the lambdas for which
+  // a - b keeps its sign, given their values and slopes at lambda_
+  void keepOrder(double a, double a_slope, double b, double b_slope);
+
+  // keepOrder of candidate winner against all other recorded candidates, then
+  // clears them. Does nothing but clear if winner is -1.
+  void keepMinimum(int winner);
+
+  // keepMinimum over the active subsets given the result of minSetTime
+  void keepMinSet(Subset* min_s);
+
+  // Appends event time and slope to the candidates of the current search.
+  // Candidates too far above the minimum so far to matter anywhere in the
+  // lambda range are dropped, keepMinimum then only checks their least slack
+  // against the winner. A new minimum is always kept.
+  void recordCandidate(double time, double slope) {
+    double change = std::fabs(slope) * candidate_width_;
+    if (time < candidate_min_) {
+      candidate_min_ = time;
+      candidate_min_change_ = change;
+    } else {
+      double slack = time - candidate_min_ - log_margin_ - change;
+      if (slack > candidate_min_change_) {
+        dropped_slack_ = std::min(dropped_slack_, slack);
+        return;
+      }
+    }
+    candidate_times_.push_back(time);
+    candidate_slopes_.push_back(slope);
+  }
+  void clearCandidates();
+
+  // kContractedEdgeScan replacement for updateEdgesGivenTightEdge. Edges which
+  // become parallel are folded into the cheapest one where that cannot change
+  // the result.
+  std::pair<double, EdgeFunctions> contractEdgesGivenTightEdge(
+      Subset* S1, Subset* S2, Subset* S);
+
+  // Sets up the contraction state for the edges in edge_functions_
+  void initContraction();
+
+  // True if edge e is cheaper than edge f by a safe margin both when finding
+  // the next event and when resolving ties
+  bool dominates(const EdgeFunctions& e, const EdgeFunctions& f) const;
+
+  // Live class of identical edges containing edge id, or -1 if it was folded
+  // into a cheaper edge
+  int foldClass(int id);
+
+  // Folds edge id (and the edges folded into it) into edge into, as identical
+  // edges if same_class
+  void foldEdge(int into, int id, bool same_class);
+
+  // Folds the (subset, index) edges from a merged subset to other subsets into
+  // the cheapest edge to the same subset where possible. Returns the sorted
+  // indices of the folded edges.
+  std::vector<size_t> foldParallelEdges(
+      const std::vector<std::pair<int, size_t>>& crossing);
+
+  // Removes the given (sorted) indices from edge_functions_ and the dead edges
+  // from the reference order, then restores the reference order
+  void removeContractedEdges(const std::vector<size_t>& dead,
+                             const std::vector<size_t>& folded);
+
+  // Sets up the reference order of all edges of G for an edge scan over the
+  // candidates_ in edge_functions_
+  void initSparse(const GraphView& G);
+
+  // Adds the growth the ends of edges in each current subset get from this
+  // event, as updateEdge applies it, to end_growth_
+  void addEndGrowth();
+
+  // Sparse scan replacement for updateEdgesGivenTightEdge. Dropped edges
+  // between S1 and S2 die with the candidates, which keeps the reference order.
+  std::pair<double, EdgeFunctions> sparseEdgesGivenTightEdge(
+      Subset* S1, Subset* S2, Subset* S);
+
+  // Removes the given (sorted) indices from edge_functions_ and the dead
+  // dropped edges from the reference order, then restores the reference order
+  void removeSparseEdges(const std::vector<size_t>& dead,
+                         const std::vector<int>& dropped);
+
+  // Dropped edges of G which could have gone tight, or been cheaper than the
+  // alt edge of the subset joining their ends, in the sparse scan just run.
+  // All of them if that cannot be told from end_growth_.
+  std::vector<int> missedEdges(const GraphView& G) const;
+
+  // Lazy dual engine state. Instead of updating every edge and subset per
+  // event, each component records the global dual clocks when it was created
+  // and deactivated, so its dual growth (and the slack of its edges) can be
+  // derived on demand. Heap keys are absolute times which stay valid until one
+  // of the endpoints changes activity.
+  struct QueueComponent {
+    Subset* subset;
+    std::list<Subset*>::iterator position;  // in subsets_
+    LinearFunctionPair initial;  // lin_s_ value when the component formed
+    LinearFunctionPair start;    // dual clocks when the component formed
+    LinearFunctionPair stop;     // dual clocks when the component went neutral
+    LinearFunction tie_credit;   // second growth skipped while marked tied
+    bool growing;                // active and not merged into another set
+    std::vector<int> members;    // dense indices of the vertices
+    std::vector<int> incident;   // edges with an endpoint in the component
+  };
+
+  struct QueueEdge {
+    int edge;               // position in the graph view
+    LinearFunction weight;  // edge weight at t_minus and t_plus
+    int head;               // dense vertex indices
+    int tail;
+    int position;  // index the edge would have in edge_functions_
+  };
+
+  // Dual growth of component c so far (first and second linear functions)
+  LinearFunctionPair growth(int c) const;
+
+  // Current lin_s_ value of component c
+  LinearFunctionPair subsetFunctions(int c) const;
+
+  // Current first and second linear functions of edge e
+  LinearFunctionPair edgeSlack(int e) const;
+
+  // Current functions of edge e with its endpoints' subsets
+  EdgeFunctions edgeFunctions(int e) const;
+
+  // Time until edge e goes tight at lambda*(1-tieeps). It must have an active
+  // endpoint.
+  double edgeTightTime(int e) const;
+
+  // Number of active endpoints of edge e, or 0 if both are in one component
+  int activeEnds(int e) const;
+
+  // Winner among the near tied (time, id) candidates at the top of a queue
+  template <typename Order>
+  std::pair<double, int> breakNearTies(
+      std::vector<std::pair<double, int>>* candidates, Order order) const;
+
+  // Next subset to go neutral and its time, or (INT_MAX, -1) if there is none.
+  // Near ties are broken like minSetTime.
+  std::pair<double, int> nextSubsetEvent() const;
+  std::pair<double, int> scanSubsetEvent() const;
+
+  // Next edge to go tight and its time, or (INT_MAX, -1) if there is none.
+  // Near ties are broken like minEdgeTime.
+  std::pair<double, int> nextEdgeEvent() const;
+  std::pair<double, int> scanEdgeEvent() const;
+
+  // Edges between components c1 and c2, sorted by position
+  std::vector<int> joiningEdges(int c1, int c2) const;
+
+  // Search through the edges joining the parents of min_e for one cheaper than
+  // min_e at lambda*(1+tieeps). Returns false if there is none.
+  bool minTiedQueueEdge(int min_e, const std::vector<int>& joining,
+                        EdgeFunctions* alt_e_functions) const;
+
+  // Stops the dual growth of component c (when it is merged or goes neutral)
+  void freezeComponent(int c);
+
+  // Merges the components joined by edge min_e into a new active component
+  void mergeComponents(int c1, int c2, const std::vector<int>& joining,
+                       const EdgeFunctions& min_e_functions);
+
+  // Removes edges (sorted by position) from edge_order_ the same way
+  // updateEdgesGivenTightEdge removes them from edge_functions_
+  void removeEdges(const std::vector<int>& removed);
+
+  // Moves edge e in the queue after an endpoint changed activity
+  void rekeyEdge(int e);
+
+  // Rekeys every live edge incident to component c and drops dead ones
+  void rekeyIncidentEdges(int c);
+
+  // Registers subset with the vectorized engine and returns its index
+  int addArraySubset(Subset* subset);
+
+  // Copies the activity and tie state of subset id into subset_flags_
+  void refreshSubsetFlags(int id);
+
+  // Functions of edge i of edge_arrays_ with its endpoints' subsets
+  EdgeFunctions arrayEdgeFunctions(int i) const;
+
+  // minTiedEdge over edge_arrays_. Returns -1 if there is no cheaper edge.
+  int minTiedArrayEdge(int min_e) const;
+
+  // Removes the edges collected per range by updateEdgeArrays
+  void removeArrayEdges(const std::vector<std::vector<size_t>>& removed);
+
+  // minEdgeArrays over all of edge_arrays_
+  std::pair<double, int> minArrayEdge() const;
+
+  // Number of ranges edge_arrays_ is split into for pool_
+  int edgeRanges() const;
+
+  // Calls f(range, begin, end) for every range of edge_arrays_ on pool_
+  template <typename F>
+  void forEachEdgeRange(F f) const;
+
   // Problem variables
+  const GraphView* graph_ = nullptr;  // view the family is built on
   double tieeps_;
   double eps_;
+  double lambda_;
   double t_minus_;
   double t_plus_;
+  GrowthEngine engine_ = GrowthEngine::kEdgeScan;
+  ThreadPool* pool_ = nullptr;  // shared, only used by kVectorEdgeScan
 
   // Optimization variables
-  std::unordered_map<int, std::shared_ptr<Subset>> vertex_subs_;
-  std::unordered_map<std::shared_ptr<Subset>, LinearFunctionPair> lin_s_;
+  SubsetArena arena_;  // owns the family built by this object
+  std::vector<LinearFunctionPair> lin_s_;  // by Subset::getId()
+  // The edge scan leaves p1 and p2 of edge_functions_ unset. Their subsets are
+  // found from the dense endpoints in edge_ends_ (kept in the same order), so
+  // a merge only unites two sets instead of rewriting every edge.
   std::vector<EdgeFunctions> edge_functions_;
-  std::shared_ptr<Edge> alt_e_;
+  std::vector<std::pair<int, int>> edge_ends_;
+  std::unordered_map<int, int> vertex_index_;  // dense index of each vertex
+  DisjointSets vertex_sets_;
+  std::vector<Subset*> set_subsets_;  // by representative
+  std::vector<uint8_t> set_flags_;  // SubsetFlags by representative
+
+  // Contracted and sparse scan variables. Edges are identified by their
+  // position in the graph view. edge_functions_ keeps one edge per class of
+  // identical edges (or the candidate edges) in the order the reference scan
+  // would find the first of them, so ties are broken the same way. Folded (or
+  // dropped) edges are only tracked to reproduce that order.
+  std::vector<std::pair<int, int>> ends_by_id_;
+  std::vector<int> edge_ids_;         // class of each edge in edge_functions_
+  std::vector<int> ref_edges_;        // edges in reference order
+  std::vector<int> ref_positions_;    // position of each edge in ref_edges_
+  std::vector<int> fold_next_;        // next edge folded into the same edge
+  std::vector<int> fold_last_;        // last edge folded into each edge
+  std::vector<int> fold_class_;       // edge it is identical to, or -1
+  std::vector<int> class_positions_;  // first position of each class
+  std::vector<int> class_first_;      // edge at that position
+  std::vector<bool> class_moved_;     // position changed by the current merge
+  std::vector<int> pair_slots_;       // cheapest edge to each subset
+  int alt_e_ = -1;  // alt edge of the next merge, by position
+
+  // Sparse scan variables
+  int neighbors_ = 0;
+  std::vector<char> candidates_;  // edges of G scanned, empty for all of them
+  std::shared_ptr<const NearestEdges> nearest_;  // of G, with the edges at
+                                                 // each dense vertex
+  std::vector<int> self_loops_left_;   // die at the first merge
+  std::vector<char> sparse_moved_;     // position changed by the current merge
+  std::vector<LinearFunctionPair> end_growth_;  // by Subset::getId()
+  bool end_growth_exact_;  // false once end_growth_ misses an edge update
+
+  // Event log variables. Searches only record the lambda range of their
+  // result while record_ is set.
+  GrowthLog* log_ = nullptr;
+  size_t replay_ = 0;  // leading events of log_ replayed without searching
+  bool record_ = false;
+  double log_margin_;   // differences closer to zero count as ties
+  double minus_slope_;  // slope in lambda of t_minus_ over t_plus_ - t_minus_
+  double plus_slope_;
+  double lambda_lo_;  // lambda range of the events so far
+  double lambda_hi_;
+  std::vector<double> candidate_times_;
+  std::vector<double> candidate_slopes_;
+  double candidate_width_;       // largest distance of the range from lambda
+  double candidate_min_;         // least time recorded so far
+  double candidate_min_change_;  // its change over candidate_width_
+  double dropped_slack_;         // least slack of a dropped candidate
+
   // TODO: clean these lin_val_ names up
   LinearFunction lin_val_;
   LinearFunction lin_val_p1_;
@@ -66,5 +397,21 @@ class GrowSubsets {
   LinearFunction lin_val_p1_plus_p2_;
 
   // Optimization outputs
-  std::list<std::shared_ptr<Subset>> subsets_;
+  std::list<Subset*> subsets_;
+
+  // Vectorized engine variables
+  EdgeArrays edge_arrays_;
+  std::vector<Subset*> array_subsets_;  // by index
+  std::vector<uint8_t> subset_flags_;   // SubsetFlags by index
+
+  // Lazy dual engine variables
+  std::vector<QueueComponent> components_;
+  std::vector<QueueEdge> queue_edges_;
+  std::vector<int> vertex_component_;  // component of each dense vertex
+  std::vector<LinearFunctionPair> vertex_base_;  // growth of merged components
+  std::vector<int> edge_order_;  // live edges in edge_functions_ order
+  std::vector<int> self_loops_;  // self loops still in edge_order_
+  IndexedMinHeap<std::pair<double, int>> edge_queue_;
+  IndexedMinHeap<std::pair<double, int>> subset_queue_;
+  LinearFunctionPair clock_;  // total growth of an always active component
 };
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// One event of GrowSubsets::build with the kEdgeScan engine
+struct GrowthEvent {
+  int neutral_set;  // set of the subset going neutral, or -1 for an edge
+  int alt_edge;     // edge cheaper at lambda*(1+tieeps) than the tight one, by
+                    // index, or -1
+  double lo;        // lambdas for which this and all earlier events are the
+  double hi;        // same
+};
+
+// Events of a build. Every decision of the build compares linear functions of
+// lambda, so a sequence of events stays the same over an interval of lambda.
+// The intervals are conservative: decisions closer than a safety margin to a
+// tie only hold at the lambda the build ran at. The exception are values which
+// are exactly equal, which are taken to stay equal (e.g. singletons with the
+// same prize), so events tied exactly may come in another order elsewhere in
+// the interval.
+struct GrowthLog {
+  std::vector<GrowthEvent> events;
+  double lo = 0.;  // lambdas for which the whole build is the same, empty if
+  double hi = -1.;  // lo > hi
+
+  // Number of leading events which are the same at lambda
+  size_t prefix(double lambda) const {
+    size_t k = 0;
+    while (k < events.size() && events[k].lo <= lambda &&
+           lambda <= events[k].hi) {
+      k++;
+    }
+    return k;
+  }
+
+  // True if a build at lambda gives the same laminar family
+  bool covers(double lambda) const { return lo <= lambda && lambda <= hi; }
+};
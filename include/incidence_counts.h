@@ -0,0 +1,76 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.h"
+#include "subset.h"
+
+// Ends of a set of edges in each subset of one component. The vertices of
+// every subset in the component are a range of the vertices of the component,
+// so counting the ends of the edges at each vertex (in a Fenwick tree over
+// those positions) makes the number in any subset a range sum. Vertices
+// outside the component are ignored.
+class IncidenceCounts {
+ public:
+  IncidenceCounts(const Subset* root,
+                  const std::list<std::shared_ptr<Edge>>& edges) {
+    int i = 0;
+    for (auto v : root->getVertices()) position_[v] = i++;
+    tree_.assign(i + 1, 0);
+    for (const auto& e : edges) add(e);
+  }
+
+  void add(const std::shared_ptr<Edge>& e) {
+    addEnd(e->getHead(), 1);
+    addEnd(e->getTail(), 1);
+  }
+
+  void remove(const std::shared_ptr<Edge>& e) {
+    addEnd(e->getHead(), -1);
+    addEnd(e->getTail(), -1);
+  }
+
+  // Number of ends in p, an edge with both ends in p counts twice
+  int count(const Subset* p) const { return count(*p); }
+  int count(const Subset& p) const {
+    auto vertices = p.getVertices();
+    int first = position_.at(vertices.front());
+    return sum(first + int(vertices.size())) - sum(first);
+  }
+
+  // True if vertex v is in p
+  bool contains(const Subset* p, int v) const {
+    auto it = position_.find(v);
+    if (it == position_.end()) return false;
+    auto vertices = p->getVertices();
+    int first = position_.at(vertices.front());
+    return first <= it->second && it->second < first + int(vertices.size());
+  }
+
+  // Number of ends of e in p
+  int ends(const Subset* p, const std::shared_ptr<Edge>& e) const {
+    return int(contains(p, e->getHead())) + int(contains(p, e->getTail()));
+  }
+
+ private:
+  void addEnd(int v, int ends) {
+    auto it = position_.find(v);
+    if (it == position_.end()) return;
+    for (size_t i = it->second + 1; i < tree_.size(); i += i & -i) {
+      tree_[i] += ends;
+    }
+  }
+
+  // Number of ends at the first n positions
+  int sum(int n) const {
+    int total = 0;
+    for (int i = n; i > 0; i -= i & -i) total += tree_[i];
+    return total;
+  }
+
+  std::unordered_map<int, int> position_;
+  std::vector<int> tree_;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// Binary min-heap over the ids 0..capacity-1 which supports changing or
+// removing the key of any id in O(log n). Keys are compared with operator<, so
+// ties can be broken deterministically by using a (time, id) pair as the key.
+template <typename Key>
+class IndexedMinHeap {
+ public:
+  explicit IndexedMinHeap(size_t capacity = 0) { reserve(capacity); }
+
+  void reserve(size_t capacity) {
+    if (capacity > position_.size()) position_.resize(capacity, kAbsent);
+    heap_.reserve(capacity);
+  }
+
+  bool empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+  bool contains(int id) const {
+    return id < static_cast<int>(position_.size()) && position_[id] != kAbsent;
+  }
+
+  int top() const { return heap_.front().second; }
+  const Key& topKey() const { return heap_.front().first; }
+  const Key& key(int id) const { return heap_[position_[id]].first; }
+
+  // Replaces the contents of the heap with the given (key, id) pairs in O(n)
+  void assign(std::vector<std::pair<Key, int>> items) {
+    for (const auto& item : heap_) position_[item.second] = kAbsent;
+    heap_ = std::move(items);
+    for (size_t i = 0; i < heap_.size(); i++) {
+      if (heap_[i].second >= static_cast<int>(position_.size()))
+        position_.resize(heap_[i].second + 1, kAbsent);
+      position_[heap_[i].second] = i;
+    }
+    for (size_t i = heap_.size() / 2; i-- > 0;) siftDown(i);
+  }
+
+  // Inserts id or changes its key if it is already in the heap
+  void set(int id, const Key& key) {
+    if (id >= static_cast<int>(position_.size())) reserve(id + 1);
+    if (position_[id] == kAbsent) {
+      position_[id] = heap_.size();
+      heap_.emplace_back(key, id);
+      siftUp(position_[id]);
+    } else {
+      size_t i = position_[id];
+      bool decreased = key < heap_[i].first;
+      heap_[i].first = key;
+      if (decreased) {
+        siftUp(i);
+      } else {
+        siftDown(i);
+      }
+    }
+  }
+
+  // Removes id from the heap if present
+  void erase(int id) {
+    if (!contains(id)) return;
+    size_t i = position_[id];
+    position_[id] = kAbsent;
+    if (i + 1 == heap_.size()) {
+      heap_.pop_back();
+      return;
+    }
+    heap_[i] = heap_.back();
+    heap_.pop_back();
+    position_[heap_[i].second] = i;
+    siftUp(i);
+    siftDown(position_[heap_[i].second]);
+  }
+
+  void pop() { erase(top()); }
+
+  // Calls f(id) for every id whose key is not greater than bound. Only the
+  // part of the heap above the bound is visited.
+  template <typename F>
+  void forEachUpTo(const Key& bound, F f) const {
+    if (heap_.empty()) return;
+    std::vector<size_t> stack{0};
+    while (!stack.empty()) {
+      size_t i = stack.back();
+      stack.pop_back();
+      if (bound < heap_[i].first) continue;
+      f(heap_[i].second);
+      if (2 * i + 1 < heap_.size()) stack.push_back(2 * i + 1);
+      if (2 * i + 2 < heap_.size()) stack.push_back(2 * i + 2);
+    }
+  }
+
+ private:
+  static constexpr size_t kAbsent = static_cast<size_t>(-1);
+
+  void siftUp(size_t i) {
+    while (i > 0) {
+      size_t parent = (i - 1) / 2;
+      if (!(heap_[i].first < heap_[parent].first)) break;
+      swapNodes(i, parent);
+      i = parent;
+    }
+  }
+
+  void siftDown(size_t i) {
+    while (true) {
+      size_t smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+      if (left < heap_.size() && heap_[left].first < heap_[smallest].first)
+        smallest = left;
+      if (right < heap_.size() && heap_[right].first < heap_[smallest].first)
+        smallest = right;
+      if (smallest == i) break;
+      swapNodes(i, smallest);
+      i = smallest;
+    }
+  }
+
+  void swapNodes(size_t i, size_t j) {
+    std::swap(heap_[i], heap_[j]);
+    position_[heap_[i].second] = i;
+    position_[heap_[j].second] = j;
+  }
+
+  std::vector<std::pair<Key, int>> heap_;
+  std::vector<size_t> position_;
+};
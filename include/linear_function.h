@@ -55,10 +55,10 @@ struct LinearFunctionPair {
 
 // TODO: Rename LinearFunctions to represent their relationship to dual constraints.
 struct EdgeFunctions {
-  std::shared_ptr<Edge> edge;
+  int edge = -1;  // position of the edge in the graph view, -1 for none
   LinearFunction first;
   LinearFunction second;
-  std::shared_ptr<Subset> p1;
-  std::shared_ptr<Subset> p2;
+  Subset* p1 = nullptr;  // endpoints' subsets, owned by the family
+  Subset* p2 = nullptr;
 };
 
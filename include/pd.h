@@ -13,33 +13,43 @@
 #include <chrono>
 #include <climits>
 #include <cmath>
+#include <exception>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <stdexcept>
 #include <stdio.h>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
-#include "graph.h"
+#include "graph_view.h"
 #include "grow_subsets.h"
 #include "problem.h"
 #include "prune.h"
+#include "subproblem_cache.h"
 #include "subset.h"
+#include "tour.h"
 
 /* ------------------------- HELPER FUNCTIONS--------------------------*/
 
 // Wrapper which solves problem instance and stores relevant solution information
-void solveInstance(SolverInfo& info);
+// With options.cache_subproblems set, subproblems are kept in cache if given,
+// so later solves of the same graph reuse them, and otherwise for this solve
+void solveInstance(SolverInfo& info, SubproblemCache* cache = nullptr);
 
 // Change all edges to alt edges
 void reverseEdges(std::shared_ptr<Subset> &s);
 
 // Calculate prize of all vertices in tree
-int prizeTree(const Graph &G, std::list<std::shared_ptr<Edge>> &tree);
+int prizeTree(const GraphView &G, std::list<std::shared_ptr<Edge>> &tree);
 
 // Finds initial l and r values such that PD(l+) > 0.5 D and PD(r-) <= 0.5 D
-void findLR(const Graph &G, double D, double &l, double &r);
+void findLR(const GraphView &G, double D, double &l, double &r,
+            const SolverOptions &options = SolverOptions());
 
 // Find all edges between subsets with alt edges and find all subsets marked
 // tied
@@ -50,12 +60,14 @@ void findTies(const std::shared_ptr<Subset> &s,
 
 /* ------------------------- MAIN FUNCTIONS--------------------------*/
 
-double findLambdaBin(const Graph &G, double D);
+double findLambdaBin(const GraphView &G, double D);
 
 // Use binary search to find theshold value lambda such that PD(lambda-) > 0.5*D
 // and PD(lambda+) <= 0.5D
-double findLambdaBin(const Graph &G, double D, bool &found, bool &swap,
-                     bool &reversed, double max_solve_time);
+// Returns -1 with found false if the search ran past max_solve_time
+double findLambdaBin(const GraphView &G, double D, bool &found, bool &swap,
+                     bool &reversed, double max_solve_time,
+                     const SolverOptions &options = SolverOptions());
 
 // Find tree within 0.5*D and save to edges
 // Tree is formed by pruning edges in reverseDelete(s) which starts > 0.5*D
@@ -68,6 +80,15 @@ std::shared_ptr<Edge> findTree(std::shared_ptr<Subset> &s, double D,
 // saved to edges An upper bound on opt is saved to upper and the number of
 // recursions in recursions (start with zero) Recurse = true or false whether or
 // not you recurse The function returns the number of visited vertices
-int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
+// Options select the algorithm variants used for every GrowSubsets call
+// Subgraphs the recursion solves are looked up in and added to cache, if given
+// complete is set, if given, to whether no search here or in the recursion
+// below was cut short by the time limit
+// Progress is written to out, in the same order whether or not the recursion
+// runs on several threads
+int PD(const GraphView &G, double D, std::list<std::shared_ptr<Edge>> &edges,
        double &upper, int &recursions, double &lambda, bool &found,
-       bool recurse = true, double max_solve_time = INT_MAX);
+       bool recurse = true, double max_solve_time = INT_MAX,
+       const SolverOptions &options = SolverOptions(),
+       SubproblemCache *cache = nullptr, bool *complete = nullptr,
+       std::ostream &out = std::cout);
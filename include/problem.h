@@ -5,6 +5,54 @@
 
 #include "graph.h"
 
+// Event loop used by GrowSubsets::build to find the next dual event
+enum class GrowthEngine {
+  kEdgeScan,            // Rescan every edge and subset after each event
+  kEventQueue,          // Keep event times in addressable heaps
+  kLazyEdgeScan,        // Rescan, but derive edge slack from dual offsets
+  kVectorEdgeScan,      // kEdgeScan over structure-of-arrays edges with SIMD
+  kContractedEdgeScan,  // kEdgeScan keeping one edge per pair of subsets
+};
+
+// Algorithm variants used by the solver. The defaults reproduce the reference
+// implementation.
+struct SolverOptions {
+  GrowthEngine growth_engine = GrowthEngine::kEdgeScan;
+  // Threads for the edge passes of kVectorEdgeScan. Results do not depend on
+  // it.
+  int num_threads = 1;
+  // Lambdas findLambdaBin evaluates at once, each on its own thread. It probes
+  // the next levels of the bisection together, so it uses 2^d - 1 of them for
+  // the largest such d. Results do not depend on it.
+  int lambda_probes = 1;
+  // Start each probe of findLambdaBin from the event log of the bracketing
+  // probe whose events are the same for longest. Only kEdgeScan keeps event
+  // logs. Results do not depend on it.
+  bool warm_start_probes = false;
+  // Take the result of a findLambdaBin probe from the probe at l or r when
+  // their event logs show the laminar family is the same, instead of building
+  // it. The bisection then only builds once per family it crosses. Only
+  // kEdgeScan keeps event logs. Results do not depend on it.
+  bool parametric_lambda_search = false;
+  // Subproblems of the recursion at the end of PD solved at once, each on its
+  // own thread. Results do not depend on it.
+  int recursion_threads = 1;
+  // Reuse the result of PD on a vertex set the recursion reaches again, in the
+  // same order and with the same budget, in this solve or in earlier ones
+  // given the same cache. Results do not depend on it.
+  bool cache_subproblems = false;
+  // If positive, kEdgeScan grows the duals over the edges from each vertex to
+  // its nearest_neighbors closest vertices and a spanning tree only. The
+  // dropped edges which could have changed the growth are found afterwards and
+  // it is run again with them, so results do not depend on it. Builds which
+  // keep an event log use all edges.
+  int nearest_neighbors = 0;
+  // After PD, shortcut the walk around the tree into a tour, shorten it by
+  // 2-opt and Or-opt moves and add vertices to it while it stays within the
+  // budget. Sets the tour fields of Solution and leaves the tree as it is.
+  bool improve_tour = false;
+};
+
 // Helper structures to organize problem specification and solution information.
 struct Problem {
   Graph graph;
@@ -14,6 +62,8 @@ struct Problem {
   std::vector<int> roots;
   // Maximum time to run solver before terminating
   double time_limit;
+  // Algorithm variants to run the solver with
+  SolverOptions options;
 };
 
 struct Solution {
@@ -21,6 +71,11 @@ struct Solution {
   std::list<std::shared_ptr<Edge>> path;
   double prize;
   double upper_bound;
+  // Tour through the vertices of path and more, when options.improve_tour is
+  // set
+  std::vector<int> tour;
+  double tour_length;
+  int tour_prize;
 };
 
 struct SolverInfo {
@@ -34,4 +89,8 @@ struct SolverInfo {
   double lambda;
   int recursions;
   double walltime;
+  // Subproblems of the recursion found in and missing from the cache during
+  // this solve, when options.cache_subproblems is set
+  int cache_hits;
+  int cache_misses;
 };
@@ -67,6 +67,61 @@ double reverseDelete(std::list<std::shared_ptr<Subset>>& subsets,
                      std::shared_ptr<Subset>& largestSub, bool l_plus = false,
                      bool swap = true);
 
+// Weights of the three variants of reverseDelete used to test a lambda
+struct ReverseDeleteWeights {
+  double minus;        // reverseDelete(subsets, false)
+  double plus;         // reverseDelete(subsets, true, true)
+  double plus_noswap;  // reverseDelete(subsets, true, false)
+};
+
+// All three in one walk of each component. Variants share the degree counts
+// of each subset as long as they have kept the same edges.
+ReverseDeleteWeights reverseDeleteAll(
+    std::list<std::shared_ptr<Subset>>& subsets);
+
+// prune(s) kept up to date while the edges and activity of the subsets of s
+// change one at a time, as in the tie search of findTree. The walk of prune is
+// kept, and a change only walks again the subsets whose step can change (those
+// whose parents gained or lost an incident kept edge) and the path from the
+// changed subset back to s.
+enum class PruneStep;
+class IncidenceCounts;
+class IncrementalPrune {
+ public:
+  explicit IncrementalPrune(const std::shared_ptr<Subset>& s);
+  ~IncrementalPrune();
+
+  // Same as reverseDelete(s)
+  double weight() const;
+
+  // Swap the edges of t, or mark t inactive, and return the new weight
+  double swapEdges(const std::shared_ptr<Subset>& t);
+  double setInactive(const std::shared_ptr<Subset>& t);
+
+ private:
+  // What the walk of prune did at a subset
+  struct Record {
+    bool visited = false;
+    bool no_edges = false;  // no edges kept yet when it was reached
+    PruneStep step;
+    std::shared_ptr<Edge> kept;  // edge kept by kBoth
+    double weight = 0;           // weight of prune from it
+  };
+
+  void walk(int from);
+  void forget(int from);
+  double recordWeight(int i) const;
+
+  std::shared_ptr<Subset> root_;
+  std::unordered_map<const Subset*, int> index_;
+  std::vector<const Subset*> subsets_;
+  std::vector<int> child_;  // subset whose parent it is, -1 for s
+  std::vector<int> parent1_, parent2_;
+  std::vector<Record> records_;
+  std::unique_ptr<IncidenceCounts> path_;     // edges kept above the walk
+  std::unique_ptr<IncidenceCounts> changed_;  // kept edges which changed
+};
+
 /* ------------------------- ALTERNATE FUNCTIONS --------------------------*/
 
 // To not keep track of edges
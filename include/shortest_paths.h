@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+#include "graph.h"
+#include "indexed_heap.h"
+
+// Lengths of shortest paths between the vertices of a graph, by vertex id.
+// Dijkstra's algorithm runs with a heap over the adjacency arrays and stops
+// once the target is reached. The search from the last source asked for is
+// kept and taken up again by the next query from it, so all distances from
+// one source cost one search. closure() finds the distances between all
+// vertices at once, for evaluating many tours. On a Euclidean graph the edge
+// is a shortest path and its length comes from the coordinates. Weights must
+// not be negative. Not safe to share between threads, and must not outlive
+// the graph.
+class ShortestPaths {
+ public:
+  explicit ShortestPaths(const Graph &G);
+
+  // Length of a shortest path from vertex i to vertex j, INT_MAX if there is
+  // none
+  double distance(int i, int j);
+
+  // Finds the distances between all vertices, one search per vertex on
+  // num_threads threads
+  void closure(int num_threads = 1);
+  bool hasClosure() const { return !table_.empty(); }
+
+ private:
+  // Dijkstra's algorithm from one source on vertex indices
+  struct Search {
+    int source = -1;
+    std::vector<double> dist;    // distances by index, final once settled
+    std::vector<char> settled;
+    IndexedMinHeap<double> heap;  // reached vertices not settled yet
+
+    void start(const Graph &G, int s);
+    // Settles vertices until target is settled, or all if target < 0
+    void run(const Graph &G, int target);
+  };
+
+  const Graph &graph_;
+  const Coordinates *coordinates_;
+  Search search_;              // from the last source asked for
+  std::vector<double> table_;  // closure, row by source index
+};
+
+// Calculate tour length with the distances of paths
+double getTourLength(ShortestPaths &paths, const std::vector<int> &tour);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.h"
+
+// What PD returns for one subgraph
+struct SubproblemResult {
+  std::list<std::shared_ptr<Edge>> edges;
+  int prize;
+  double upper;
+  int recursions;
+  double lambda;
+  bool complete;  // no search in it was cut short by the time limit
+};
+
+// Results of PD on the subgraphs the recursion solves, by vertex set and
+// budget, so a vertex set reached again is not solved again. The subgraph of a
+// vertex set keeps the order of its vertices, which breaks ties of the
+// algorithm, so sets only match in the same order. Within one solve the
+// recursion seldom reaches a set again; a cache kept across solves of the same
+// graph finds every subproblem a solve before it finished. It must not be used
+// for another graph. Safe to share between threads.
+class SubproblemCache {
+ public:
+  // Sets result and returns true if the subgraph on vertices was solved before
+  bool find(const std::vector<int> &vertices, double budget,
+            SubproblemResult *result);
+  void insert(const std::vector<int> &vertices, double budget,
+              const SubproblemResult &result);
+
+  int hits() const;
+  int misses() const;
+
+ private:
+  struct Key {
+    std::vector<int> vertices;
+    double budget;
+
+    bool operator==(const Key &other) const {
+      return budget == other.budget && vertices == other.vertices;
+    }
+  };
+
+  // Hash of the vertices and the budget
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, SubproblemResult, KeyHash> results_;
+  int hits_ = 0;
+  int misses_ = 0;
+};
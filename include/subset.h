@@ -17,16 +17,23 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "graph.h"
+#include "vertex_range.h"
 
 /* -------------------------SUBSETS--------------------------*/
 
 class Subset {
  private:
-  std::list<int> vertices;          // vertices in set
-  std::shared_ptr<Subset> parent1;  // parent subset 1
-  std::shared_ptr<Subset> parent2;  // parent subset 2
+  VertexNode vertex;                // vertex of a singleton set
+  VertexNode *first;                // first and last vertex in set, shared
+  VertexNode *last;                 // with the ancestors
+  size_t size;                      // number of vertices in set
+  int id;                           // index in its family, -1 if not set
+  Subset *parent1;                  // parent subset 1, owned by the family
+  Subset *parent2;                  // parent subset 2
   std::shared_ptr<Edge> edge;       // tight edge between parents
   std::shared_ptr<Edge> alt_edge;   // edge tight at lambda+eps
 
@@ -40,23 +47,29 @@ class Subset {
  public:
   // Constructors and Destructors
   Subset(int v, double pot, int pr = 1);
+  Subset(Subset *p1, Subset *p2, const std::shared_ptr<Edge> e,
+         const std::shared_ptr<Edge> alt_e = NULL);
+  // Use for merges, with an alt edge if any. The parents are not owned and
+  // must outlive the merged set, SubsetArena keeps a family together
   Subset(const std::shared_ptr<Subset> p1, const std::shared_ptr<Subset> p2,
-         const std::shared_ptr<Edge> e);  // Use for merges
-  Subset(const std::shared_ptr<Subset> p1, const std::shared_ptr<Subset> p2,
-         const std::shared_ptr<Edge> e, const std::shared_ptr<Edge> alt_e);
-  // Use for merges with alt edges
-  ~Subset();
+         const std::shared_ptr<Edge> e,
+         const std::shared_ptr<Edge> alt_e = NULL)
+      : Subset(p1.get(), p2.get(), e, alt_e) {}
+  // Copies would share the vertex chain of the original
+  Subset(const Subset &) = delete;
+  Subset &operator=(const Subset &) = delete;
 
   // Get Functions
-  std::list<int> const &getVertices() const { return vertices; }
-  std::shared_ptr<Subset> const &getParent1() const { return parent1; }
-  std::shared_ptr<Subset> const &getParent2() const { return parent2; }
+  VertexRange getVertices() const { return VertexRange(first, last, size); }
+  Subset *getParent1() const { return parent1; }
+  Subset *getParent2() const { return parent2; }
   std::shared_ptr<Edge> const &getEdge() const { return edge; }
   std::shared_ptr<Edge> const &getAltEdge() const { return alt_edge; }
   double getPotential() const { return potential; }
   double getY() const { return y_val; }
   double getEdgeTotal() const { return edge_total; }
   int getPrize() const { return prize; }
+  int getId() const { return id; }
   inline bool getActive() const { return active; }
   inline bool getTied() const { return tied; }
 
@@ -66,6 +79,7 @@ class Subset {
   void setActive(bool b) { active = b; }
   void setTied(bool b) { tied = b; }
   void setPotential(double p) { potential = p; }
+  void setId(int i) { id = i; }
 
   // Print Function
   friend std::ostream &operator<<(std::ostream &out, const Subset &S);
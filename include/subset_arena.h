@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "subset.h"
+
+// Allocates the subsets of one laminar family from large blocks. Nothing is
+// freed one subset at a time, the family is destroyed together once the arena
+// and every pointer shared from it are gone. Within a build subsets are
+// handled by raw pointer, only the roots handed out are shared, and those all
+// share the one reference count of the family.
+// Subsets are numbered 0, 1, ... in the order they are made, so per subset
+// state can be kept in flat arrays indexed by Subset::getId().
+class SubsetArena {
+ public:
+  SubsetArena() : family_(std::make_shared<Family>()) {}
+
+  // Makes a subset with the given Subset constructor arguments
+  template <typename... Args>
+  Subset *make(Args &&... args) {
+    void *memory = family_->allocate(sizeof(Subset), alignof(Subset));
+    Subset *subset = new (memory) Subset(std::forward<Args>(args)...);
+    family_->subsets.push_back(subset);
+    subset->setId(size_++);
+    return subset;
+  }
+
+  // Shared pointer to a subset of this family, which keeps the whole family
+  // alive
+  std::shared_ptr<Subset> share(Subset *subset) const {
+    return std::shared_ptr<Subset>(family_, subset);
+  }
+
+  // Subset numbered id
+  Subset *get(int id) const { return family_->subsets[id]; }
+
+  // Number of subsets made so far
+  int size() const { return size_; }
+
+ private:
+  // Bump allocator over a list of blocks, destroying the subsets placed in
+  // them when the last pointer to the family goes
+  class Family {
+   public:
+    Family() = default;
+    Family(const Family &) = delete;
+    Family &operator=(const Family &) = delete;
+    ~Family();
+
+    void *allocate(size_t bytes, size_t alignment);
+
+    std::vector<Subset *> subsets;  // in the order they were made
+
+   private:
+    static const size_t kBlockSize = 1 << 16;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t used_ = kBlockSize;  // bytes used of the last block
+  };
+
+  std::shared_ptr<Family> family_;
+  int size_ = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads which run the tasks of one parallel loop at a
+// time. The calling thread works on the loop as well, so a pool of size n
+// starts n-1 threads.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int size() const { return workers_.size() + 1; }
+
+  // Calls task(i) for every i in [0, num_tasks) and returns when all are done.
+  // Concurrent callers are served one loop after the other.
+  void run(int num_tasks, const std::function<void(int)>& task);
+
+  // Process wide pool with num_threads threads, started on first use and kept
+  // for the lifetime of the program
+  static ThreadPool& shared(int num_threads);
+
+ private:
+  void work();
+
+  // Runs tasks of the current loop until none are left
+  void runTasks(std::unique_lock<std::mutex>& lock);
+
+  std::vector<std::thread> workers_;
+  std::mutex run_mutex_;  // held for the duration of run()
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(int)>* task_ = nullptr;
+  int num_tasks_ = 0;
+  int next_task_ = 0;
+  int running_ = 0;  // tasks started but not finished
+  unsigned generation_ = 0;
+  bool stop_ = false;
+};
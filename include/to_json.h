@@ -10,9 +10,13 @@
 void to_json(nlohmann::json& j, const Edge& e);
 void to_json(nlohmann::json& j, const std::shared_ptr<Edge>& e);
 
+// A vertex on its own, with the edges added to it
 void to_json(nlohmann::json& j, const Vertex& v);
 void to_json(nlohmann::json& j, const std::shared_ptr<Vertex>& v);
 
+// The vertices of a graph, each with its edges in the graph
+void to_json(nlohmann::json& j, const Graph& G);
+
 void to_json(nlohmann::json& j, const Subset& s);
 void to_json(nlohmann::json& j, const std::shared_ptr<Subset>& s);
 
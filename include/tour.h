@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "graph.h"
+#include "problem.h"
+#include "shortest_paths.h"
+
+// Tours are closed, a vector of vertex ids with an edge back from the last to
+// the first, and are measured with the distances of paths.
+
+// Shortens tour by 2-opt and Or-opt moves between vertices close to each
+// other. Returns the new length of tour, given its length.
+double improveTour(ShortestPaths &paths, std::vector<int> &tour, double length);
+
+// Adds vertices of G to tour, the most prize per added length first, while its
+// length stays within budget. Returns the new length of tour, given its length.
+double insertVertices(const Graph &G, ShortestPaths &paths,
+                      std::vector<int> &tour, double length, double budget);
+
+// Removes vertices from tour, the least prize per saved length first, until
+// its length is within budget. Returns the new length of tour, given its
+// length.
+double dropVertices(const Graph &G, ShortestPaths &paths,
+                    std::vector<int> &tour, double length, double budget);
+
+// Post-processing in solveInstance: shortcuts the walk around the tree of
+// solution into a tour, and then improves it and fills the budget by turns
+// until no vertex fits. PD may leave a forest, whose walk can be over budget
+// until vertices are dropped. Sets the tour fields of solution.
+void buildTour(const Problem &problem, Solution &solution);
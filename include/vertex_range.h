@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+// One vertex of the laminar family. Every vertex is stored once, in the
+// singleton subset created for it, and merging two subsets links the last
+// vertex of the first parent to the first vertex of the second. The vertices
+// of any subset are then the chain between its first and last node.
+struct VertexNode {
+  int vertex;
+  VertexNode *next = nullptr;
+};
+
+// Read only view of the vertices of a subset, in the order they were merged
+class VertexRange {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const int *;
+    using reference = const int &;
+
+    iterator() = default;
+    iterator(const VertexNode *node, const VertexNode *last)
+        : node_(node), last_(last) {}
+
+    reference operator*() const { return node_->vertex; }
+    pointer operator->() const { return &node_->vertex; }
+    iterator &operator++() {
+      node_ = node_ == last_ ? nullptr : node_->next;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++*this;
+      return it;
+    }
+    bool operator==(const iterator &other) const {
+      return node_ == other.node_;
+    }
+    bool operator!=(const iterator &other) const {
+      return node_ != other.node_;
+    }
+
+   private:
+    const VertexNode *node_ = nullptr;
+    const VertexNode *last_ = nullptr;
+  };
+  using const_iterator = iterator;
+  using value_type = int;
+
+  VertexRange(const VertexNode *first, const VertexNode *last, size_t size)
+      : first_(first), last_(last), size_(size) {}
+
+  iterator begin() const { return iterator(first_, last_); }
+  iterator end() const { return iterator(); }
+  int front() const { return first_->vertex; }
+  int back() const { return last_->vertex; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  const VertexNode *first_;
+  const VertexNode *last_;
+  size_t size_;
+};
@@ -0,0 +1,170 @@
+#include "edge_arrays.h"
+
+#include <climits>
+
+// The search uses AVX when the build enables it (e.g. -mavx2), SSE2 on any
+// other x86-64 build and a plain loop elsewhere.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define EDGE_ARRAYS_SIMD 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define EDGE_ARRAYS_SIMD 1
+#endif
+
+void EdgeArrays::push_back(int32_t edge, const LinearFunction& first,
+                           const LinearFunction& second, int32_t s1,
+                           int32_t s2) {
+  first_minus.push_back(first.t_minus);
+  first_plus.push_back(first.t_plus);
+  second_minus.push_back(second.t_minus);
+  second_plus.push_back(second.t_plus);
+  tight_time.push_back(INT_MAX);
+  p1.push_back(s1);
+  p2.push_back(s2);
+  edges.push_back(edge);
+}
+
+void EdgeArrays::move(size_t from, size_t to) {
+  first_minus[to] = first_minus[from];
+  first_plus[to] = first_plus[from];
+  second_minus[to] = second_minus[from];
+  second_plus[to] = second_plus[from];
+  tight_time[to] = tight_time[from];
+  p1[to] = p1[from];
+  p2[to] = p2[from];
+  edges[to] = edges[from];
+}
+
+void EdgeArrays::resize(size_t size) {
+  first_minus.resize(size);
+  first_plus.resize(size);
+  second_minus.resize(size);
+  second_plus.resize(size);
+  tight_time.resize(size);
+  p1.resize(size);
+  p2.resize(size);
+  edges.resize(size);
+}
+
+void updateEdgeArrays(const DualGrowth& growth, const uint8_t* flags,
+                      const SubsetChange& change, size_t begin, size_t end,
+                      EdgeArrays* arrays, std::vector<size_t>* removed) {
+  // Amount subtracted per endpoint, indexed by its active and tied bits. An
+  // endpoint which does not grow subtracts +0.0, which leaves the value
+  // unchanged, so the update needs no branches per endpoint. The loop is
+  // bound by memory traffic, explicit SIMD here measured slower because every
+  // lane needs its own table lookups.
+  const double first_minus[4] = {0., growth.first.t_minus, 0.,
+                                 growth.first.t_minus};
+  const double first_plus[4] = {0., growth.first.t_plus, 0.,
+                                growth.first.t_plus};
+  const double second_minus[4] = {0., growth.p1_plus_p2.t_minus,
+                                  growth.p1.t_minus, growth.p1.t_minus};
+  const double second_plus[4] = {0., growth.p1_plus_p2.t_plus, growth.p1.t_plus,
+                                 growth.p1.t_plus};
+  const double inverse_ends[3] = {1., 1., 0.5};
+
+  double* fm = arrays->first_minus.data();
+  double* fp = arrays->first_plus.data();
+  double* sm = arrays->second_minus.data();
+  double* sp = arrays->second_plus.data();
+  double* times = arrays->tight_time.data();
+  int32_t* p1 = arrays->p1.data();
+  int32_t* p2 = arrays->p2.data();
+  for (size_t i = begin; i < end; i++) {
+    int32_t a = p1[i], b = p2[i];
+    int c1 = flags[a] & (kSubsetActive | kSubsetTied);
+    int c2 = flags[b] & (kSubsetActive | kSubsetTied);
+    // Edges without an active endpoint are skipped entirely
+    int grows = (c1 | c2) & kSubsetActive;
+    c1 *= grows;
+    c2 *= grows;
+
+    if (grows) {
+      fm[i] = fm[i] - first_minus[c1] - first_minus[c2];
+      fp[i] = fp[i] - first_plus[c1] - first_plus[c2];
+      sm[i] = sm[i] - second_minus[c1] - second_minus[c2];
+      sp[i] = sp[i] - second_plus[c1] - second_plus[c2];
+    }
+
+    if (a == change.s1 || a == change.s2) a = p1[i] = change.merged;
+    if (b == change.s1 || b == change.s2) b = p2[i] = change.merged;
+    int k = int((flags[a] & kSubsetActive) && a != change.neutral) +
+            int((flags[b] & kSubsetActive) && b != change.neutral);
+    if (a == b) {
+      k = 0;
+      if (removed != nullptr) removed->push_back(i);
+    }
+    times[i] = k == 0 ? INT_MAX : fm[i] * inverse_ends[k];
+  }
+}
+
+std::vector<std::pair<size_t, size_t>> removalMoves(
+    const EdgeArrays& arrays, const std::vector<size_t>& removed) {
+  // Removing by swapping with the back fills the k-th removed slot below the
+  // new size with the k-th remaining edge counted from the back
+  std::vector<std::pair<size_t, size_t>> moves;
+  size_t size = arrays.size() - removed.size();
+  size_t back = arrays.size();
+  auto last_removed = removed.rbegin();
+  for (size_t hole : removed) {
+    if (hole >= size) break;
+    while (true) {
+      back--;
+      if (last_removed == removed.rend() || *last_removed != back) break;
+      ++last_removed;
+    }
+    moves.emplace_back(back, hole);
+  }
+  return moves;
+}
+
+std::pair<double, int> minEdgeArrays(const EdgeArrays& arrays, double eps,
+                                     size_t begin, size_t end,
+                                     std::pair<double, int> best) {
+  const double* times = arrays.tight_time.data();
+  double time_e = best.first;
+  int optimizer = best.second;
+  size_t i = begin;
+#ifdef EDGE_ARRAYS_SIMD
+  // Compare a block of times at once and only walk through it serially if
+  // one of them beats the current minimum
+#if defined(__AVX__)
+  constexpr size_t kLanes = 4;
+  for (; i + kLanes <= end; i += kLanes) {
+    __m256d block = _mm256_loadu_pd(times + i);
+    __m256d bound = _mm256_set1_pd(time_e - eps);
+    if (!_mm256_movemask_pd(_mm256_cmp_pd(block, bound, _CMP_LT_OQ))) continue;
+#else
+  constexpr size_t kLanes = 2;
+  for (; i + kLanes <= end; i += kLanes) {
+    __m128d block = _mm_loadu_pd(times + i);
+    __m128d bound = _mm_set1_pd(time_e - eps);
+    if (!_mm_movemask_pd(_mm_cmplt_pd(block, bound))) continue;
+#endif
+    for (size_t j = i; j < i + kLanes; j++) {
+      if (times[j] < time_e - eps) {
+        time_e = times[j];
+        optimizer = j;
+      }
+    }
+  }
+#endif
+  for (; i < end; i++) {
+    if (times[i] < time_e - eps) {
+      time_e = times[i];
+      optimizer = i;
+    }
+  }
+  return std::make_pair(time_e, optimizer);
+}
+
+double minTightTime(const EdgeArrays& arrays, size_t begin, size_t end) {
+  const double* times = arrays.tight_time.data();
+  double time_e = INT_MAX;
+  for (size_t i = begin; i < end; i++) {
+    time_e = times[i] < time_e ? times[i] : time_e;
+  }
+  return time_e;
+}
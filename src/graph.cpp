@@ -10,6 +10,13 @@
 
 #include "graph.h"
 
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#include "graph_view.h"
+#include "shortest_paths.h"
+
 /* -------------------------EDGE--------------------------*/
 
 // Create an edge
@@ -17,6 +24,7 @@ Edge::Edge(int h, int t, double w) {
   head = h;
   tail = t;
   weight = w;
+  index = -1;
 }
 
 // Delete an edge
@@ -73,6 +81,15 @@ void Vertex::addEdge(std::shared_ptr<Edge> e) {
   }
 }
 
+// Return the list of neighbors, which the graph of the vertex makes on first
+// use
+std::list<std::shared_ptr<Edge>> const &Vertex::getIncEdges() const {
+  if (graph != nullptr) {
+    graph->listEdges(*this);
+  }
+  return neighbors;
+}
+
 // Remove an edge from the list of neighbors
 void Vertex::removeEdge(std::shared_ptr<Edge> e) {
   neighbors.remove(e);
@@ -88,6 +105,8 @@ void Vertex::removeEdge(std::shared_ptr<Edge> e) {
 Graph::Graph() {
   W = 0.0;  // Nothing else to do
   P = 0.0;
+  edges_made = edge_ptrs_made = false;
+  vertices_listed = edges_listed = false;
 }
 
 Graph::~Graph() {
@@ -96,31 +115,39 @@ Graph::~Graph() {
 
 // copy constructor
 Graph::Graph(const Graph &G) {
+  edges_made = edge_ptrs_made = false;
+  vertices_listed = edges_listed = false;
   W = G.W;
   P = G.P;
-  std::list<int>::const_iterator it;
-  for (it = G.vertices.begin(); it != G.vertices.end(); it++) {
-    vertices.push_back(*it);
-    int i = *it;
-    int p = G.getVertex(i)->getPrize();
-    std::shared_ptr<Vertex> v = std::make_shared<Vertex>(i, p);
-    vertex_map[*it] = v;
+  vertices = G.vertices;
+  vertex_index = G.vertex_index;
+  for (const auto &v : G.vertex_data) {
+    vertex_data.push_back(makeVertex(v->id, v->prize));
+    vertex_data.back()->degree = v->degree;
   }
 
-  std::list<std::shared_ptr<Edge>>::const_iterator it2;
-  for (it2 = G.edges.begin(); it2 != G.edges.end(); it2++) {
-    int id1 = (**it2).getHead();
-    int id2 = (**it2).getTail();
-    double w = (**it2).getWeight();
-    std::shared_ptr<Edge> e = std::make_shared<Edge>(id1, id2, w);
-    vertex_map[id1]->addEdge(e);
-    vertex_map[id2]->addEdge(e);
-    edges.push_back(e);
+  // A Euclidean graph makes its own edges when it needs them
+  coordinates = G.coordinates;
+  if (coordinates != nullptr) {
+    return;
+  }
+  edge_records = G.edge_records;
+  adjacency = std::atomic_load(&G.adjacency);
+  edges.reserve(G.edges.size());
+  for (const auto &e : G.edges) {
+    edges.push_back(std::make_shared<Edge>(*e));
   }
 }
 
-// subgraph constructor
-Graph::Graph(const Graph &G, const std::list<int> &S) {
+// subgraph constructors
+Graph::Graph(const Graph &G, const std::list<int> &S) { addSubgraph(G, S); }
+
+Graph::Graph(const Graph &G, const VertexRange &S) { addSubgraph(G, S); }
+
+template <typename Vertices>
+void Graph::addSubgraph(const Graph &G, const Vertices &S) {
+  edges_made = edge_ptrs_made = false;
+  vertices_listed = edges_listed = false;
   W = 0;
   P = 0;
   // add vertices in S
@@ -130,21 +157,24 @@ Graph::Graph(const Graph &G, const std::list<int> &S) {
   }
 
   // add edges with both endpts in S
-  for (auto e : G.getEdges()) {
-    int id1 = e->getHead(), id2 = e->getTail();
-    double w = e->getWeight();
-
-    if ((vertex_map.count(id1) > 0) && (vertex_map.count(id2) > 0)) {
-      addEdge(id1, id2, w);
-    }
+  GraphView view(G, S);
+  const std::vector<EdgeRecord> &records = G.getEdgeRecords();
+  for (size_t k = 0; k < view.getEdgeCount(); k++) {
+    const EdgeRecord &r = records[view.getEdgeIndex(k)];
+    addEdge(G.vertices[r.head], G.vertices[r.tail], r.weight);
   }
 }
 
 // Add a vertex to a graph with a prize
 void Graph::addVertex(int id, int p) {
+  dropCoordinates();
+  vertex_index[id] = vertices.size();
   vertices.push_back(id);
-  std::shared_ptr<Vertex> v = std::make_shared<Vertex>(id, p);
-  vertex_map[id] = v;
+  vertex_data.push_back(makeVertex(id, p));
+  if (vertices_listed) {
+    vertex_list.push_back(id);
+  }
+  adjacency = nullptr;
   P += p;
 }
 
@@ -153,84 +183,333 @@ void Graph::addVertex(int id) { addVertex(id, 1); }
 
 // Add an edge to a graph
 void Graph::addEdge(int id1, int id2, double weight) {
-  if ((vertex_map[id1] == NULL) || (vertex_map[id2] == NULL)) {
+  dropCoordinates();
+  int i1 = findIndex(id1), i2 = findIndex(id2);
+  if ((i1 < 0) || (i2 < 0)) {
     return;
   }
   std::shared_ptr<Edge> e = std::make_shared<Edge>(id1, id2, weight);
-  vertex_map[id1]->addEdge(e);
-  vertex_map[id2]->addEdge(e);
+  e->index = edges.size();
+  edge_records.push_back(EdgeRecord{static_cast<uint32_t>(i1),
+                                    static_cast<uint32_t>(i2), weight});
   edges.push_back(e);
-  if (weight < 0) {
-    W -= weight;
-  } else {
-    W += weight;
+  adjacency = nullptr;
+  if (edges_listed) {
+    edge_list.push_back(e);
+  }
+  for (int i : {i1, i2}) {
+    if (vertex_data[i]->listed) vertex_data[i]->neighbors.push_back(e);
   }
+  double w = weight < 0 ? -weight : weight;
+  vertex_data[i1]->degree += w;
+  vertex_data[i2]->degree += w;
+  W += w;
 }
 
 // Return ptr to vertex
 std::shared_ptr<Vertex> const &Graph::getVertex(int id) const {
-  if (vertex_map.count(id) == 0) {
+  return vertex_data[getIndex(id)];
+}
+
+// Return index of vertex, or -1 if it is not in the graph
+int Graph::findIndex(int id) const {
+  auto it = vertex_index.find(id);
+  return it == vertex_index.end() ? -1 : it->second;
+}
+
+// Return index of vertex
+int Graph::getIndex(int id) const {
+  int i = findIndex(id);
+  if (i < 0) {
     throw std::invalid_argument("Vertex does not exist");
   }
-  return vertex_map.at(id);
+  return i;
 }
 
 // Return vertex degree
 double Graph::getVertexDegree(int id) const {
-  if (vertex_map.count(id) == 0) {
-    throw std::invalid_argument("Vertex does not exist");
+  return getVertex(id)->getDegree();
+}
+
+// A vertex of this graph
+std::shared_ptr<Vertex> Graph::makeVertex(int id, int prize) {
+  auto v = std::make_shared<Vertex>(id, prize);
+  v->graph = this;
+  return v;
+}
+
+// Return the list of vertex ids
+std::list<int> const &Graph::getVertices() const {
+  std::lock_guard<std::mutex> lock(lists_mutex);
+  if (!vertices_listed) {
+    vertex_list.assign(vertices.begin(), vertices.end());
+    vertices_listed = true;
+  }
+  return vertex_list;
+}
+
+// Return the list of edge pointers
+std::list<std::shared_ptr<Edge>> const &Graph::getEdges() const {
+  needEdgePtrs();
+  std::lock_guard<std::mutex> lock(lists_mutex);
+  if (!edges_listed) {
+    edge_list.assign(edges.begin(), edges.end());
+    edges_listed = true;
   }
-  return vertex_map.at(id)->getDegree();
+  return edge_list;
 }
 
-// Remove vertex from list of vertices and vertex unordered_map
-void Graph::removeVertexLists(int id) {
-  vertices.remove(id);
-  vertex_map.erase(id);
+// List the edges at v, from the adjacency arrays
+void Graph::listEdges(const Vertex &v) const {
+  std::lock_guard<std::mutex> lock(lists_mutex);
+  if (!v.listed) {
+    std::vector<std::shared_ptr<Edge>> inc = getIncEdges(v.id);
+    v.neighbors.assign(inc.begin(), inc.end());
+    v.listed = true;
+  }
 }
 
-// Delete a vertex from a graph
-void Graph::deleteVertex(int id) {
-  std::shared_ptr<Vertex> p_v = vertex_map[id];
-  if (p_v == NULL) {
+// Drop the edge lists, when the edges are made again
+void Graph::unlist() {
+  edge_list.clear();
+  edges_listed = false;
+  for (auto &v : vertex_data) {
+    v->neighbors.clear();
+    v->listed = false;
+  }
+}
+
+// Return the edges at a vertex, in the order they were added
+std::vector<std::shared_ptr<Edge>> Graph::getIncEdges(int id) const {
+  const Adjacency &adj = getAdjacency();
+  int i = getIndex(id);
+  std::vector<std::shared_ptr<Edge>> inc;
+  for (uint32_t k = adj.offsets[i]; k < adj.offsets[i + 1]; k++) {
+    inc.push_back(getEdgePtr(adj.edges[k]));
+  }
+  return inc;
+}
+
+// Adjacency arrays of the edges with the given ends on n vertices. Count the
+// edge ends at each vertex, then place the edges in order.
+static Adjacency makeAdjacency(const std::vector<EdgeRecord> &records,
+                               size_t n) {
+  Adjacency adj;
+  adj.offsets.assign(n + 1, 0);
+  for (const auto &e : records) {
+    adj.offsets[e.head + 1]++;
+    adj.offsets[e.tail + 1]++;
+  }
+  for (size_t i = 0; i < n; i++) {
+    adj.offsets[i + 1] += adj.offsets[i];
+  }
+  adj.edges.resize(2 * records.size());
+  std::vector<uint32_t> next(adj.offsets.begin(), adj.offsets.end() - 1);
+  for (uint32_t k = 0; k < records.size(); k++) {
+    adj.edges[next[records[k].head]++] = k;
+    adj.edges[next[records[k].tail]++] = k;
+  }
+  return adj;
+}
+
+// Return the adjacency arrays, made on first use after a change. Threads
+// reading the graph may make them at the same time, then one set is kept.
+const Adjacency &Graph::getAdjacency() const {
+  needEdges();
+  std::shared_ptr<const Adjacency> adj = std::atomic_load(&adjacency);
+  if (adj != nullptr) {
+    return *adj;
+  }
+
+  auto made =
+      std::make_shared<Adjacency>(makeAdjacency(edge_records, vertices.size()));
+
+  // The graph owns whichever set is stored first, so the reference stays valid
+  std::shared_ptr<const Adjacency> expected;
+  adj = made;
+  if (!std::atomic_compare_exchange_strong(&adjacency, &expected, adj)) {
+    adj = expected;
+  }
+  return *adj;
+}
+
+// Make the graph the complete Euclidean graph on its vertices. Only the total
+// weight and the degrees are worked out now, in the order the edges would be
+// added, so they come out the same as if the edges were added one by one.
+void Graph::setCoordinates(std::vector<int> x, std::vector<int> y) {
+  coordinates = nullptr;
+  edges_made = edge_ptrs_made = false;
+  edge_records.clear();
+  edges.clear();
+  adjacency = nullptr;
+  unlist();
+  W = 0;
+  for (auto &v : vertex_data) {
+    v->degree = 0;
+  }
+
+  auto xy = std::make_shared<Coordinates>();
+  xy->x = std::move(x);
+  xy->y = std::move(y);
+  size_t n = xy->x.size();
+  std::vector<int> index(n);
+  for (size_t h = 0; h < n; h++) {
+    index[h] = findIndex(h);
+  }
+
+  // The distances of a row are independent, so they are worked out in one
+  // loop over the coordinates before they are added up in order
+  std::vector<double> row(n);
+  for (size_t h = 0; h < n; h++) {
+    const int xh = xy->x[h], yh = xy->y[h];
+    const int *xs = xy->x.data(), *ys = xy->y.data();
+    for (size_t t = 0; t < h; t++) {
+      int dx = xh - xs[t], dy = yh - ys[t];
+      row[t] = std::sqrt(dx * dx + dy * dy);
+    }
+    if (index[h] < 0) continue;
+    for (size_t t = 0; t < h; t++) {
+      if (index[t] < 0) continue;
+      W += row[t];
+      vertex_data[index[h]]->degree += row[t];
+      vertex_data[index[t]]->degree += row[t];
+    }
+  }
+  coordinates = xy;
+}
+
+// Make the edge records of a Euclidean graph: from each vertex to the ones
+// before it and then a loop. The Edge objects are left to getEdgePtr.
+void Graph::makeEdges() const {
+  std::lock_guard<std::mutex> lock(edges_mutex);
+  if (edges_made) {
+    return;
+  }
+  const Coordinates &xy = *coordinates;
+  size_t n = xy.x.size();
+  std::vector<int> index(n);
+  size_t m = 0;
+  for (size_t h = 0; h < n; h++) {
+    index[h] = findIndex(h);
+    if (index[h] >= 0) m++;
+  }
+  edge_records.reserve(m * (m + 1) / 2);
+
+  auto add = [&](int h, int t, double w) {
+    edge_records.push_back(EdgeRecord{static_cast<uint32_t>(index[h]),
+                                      static_cast<uint32_t>(index[t]), w});
+  };
+  for (size_t h = 0; h < n; h++) {
+    if (index[h] < 0) continue;
+    for (size_t t = 0; t < h; t++) {
+      if (index[t] >= 0) add(h, t, xy.distance(h, t));
+    }
+    add(h, h, 0.0);
+  }
+  edges.resize(edge_records.size());
+  edges_made = true;
+}
+
+// Make the Edge objects of a Euclidean graph which are not made yet
+void Graph::makeEdgePtrs() const {
+  needEdges();
+  std::lock_guard<std::mutex> lock(edges_mutex);
+  if (edge_ptrs_made) {
     return;
   }
+  for (size_t k = 0; k < edges.size(); k++) {
+    getEdgePtr(k);
+  }
+  edge_ptrs_made = true;
+}
 
-  // Update prize
-  P -= p_v->getPrize();
+// Return the edge with index k. The edges of a Euclidean graph are made on
+// first use. Threads may make one at the same time, then one of them is kept.
+std::shared_ptr<Edge> Graph::getEdgePtr(int k) const {
+  needEdges();
+  if (coordinates == nullptr) {
+    return edges[k];
+  }
+  std::shared_ptr<Edge> e = std::atomic_load(&edges[k]);
+  if (e != nullptr) {
+    return e;
+  }
+  const EdgeRecord &r = edge_records[k];
+  auto made =
+      std::make_shared<Edge>(vertices[r.head], vertices[r.tail], r.weight);
+  made->index = k;
+  if (std::atomic_compare_exchange_strong(&edges[k], &e, made)) {
+    e = made;
+  }
+  return e;
+}
+
+// Turn a Euclidean graph into one with its edges kept, before changing it
+void Graph::dropCoordinates() {
+  needEdgePtrs();
+  coordinates = nullptr;
+}
 
-  // If no edges to go through just remove references and delete vertex
-  if (p_v->getIncEdges().size() == 0) {
-    removeVertexLists(id);
+// Delete a vertex from a graph
+void Graph::deleteVertex(int id) {
+  dropCoordinates();
+  int i = findIndex(id);
+  if (i < 0) {
     return;
   }
 
-  // Iterate through edges
-  std::list<std::shared_ptr<Edge>>::iterator it;
-  for (it = edges.begin(); it != edges.end();) {
-    if (((*it)->getHead() == id) || ((*it)->getTail() == id)) {
-      // Delete other vertice's pointer to the edge and the lists's pointer
-      if ((*it)->getWeight() < 0) {
-        W += (*it)->getWeight();
-      } else {
-        W -= (*it)->getWeight();
-      }
-      int j = (*it)->getOther(id);
-      vertex_map[j]->removeEdge(*it);
-      edges.erase(it++);
+  // Update prize
+  P -= vertex_data[i]->getPrize();
+
+  // Iterate through edges, keeping the others in order
+  size_t kept = 0;
+  for (size_t k = 0; k < edges.size(); k++) {
+    EdgeRecord r = edge_records[k];
+    if ((r.head == static_cast<uint32_t>(i)) ||
+        (r.tail == static_cast<uint32_t>(i))) {
+      // Delete the other vertex's degree and the edge
+      double w = r.weight < 0 ? -r.weight : r.weight;
+      W -= w;
+      vertex_data[r.head]->degree -= w;
+      if (r.tail != r.head) vertex_data[r.tail]->degree -= w;
+      edges[k]->index = -1;
     } else {
-      ++it;
+      // Later vertices move down one index
+      if (r.head > static_cast<uint32_t>(i)) r.head--;
+      if (r.tail > static_cast<uint32_t>(i)) r.tail--;
+      edges[k]->index = kept;
+      edge_records[kept] = r;
+      if (kept != k) edges[kept] = std::move(edges[k]);
+      kept++;
     }
   }
-
-  // Delete references in the unordered_map/list
-  removeVertexLists(id);
+  edge_records.resize(kept);
+  edges.resize(kept);
+
+  // Delete references in the vectors/unordered_map and the lists
+  vertices.erase(vertices.begin() + i);
+  vertex_data.erase(vertex_data.begin() + i);
+  vertex_index.erase(id);
+  auto deleted = [](const std::shared_ptr<Edge> &e) { return e->index < 0; };
+  if (vertices_listed) {
+    vertex_list.remove(id);
+  }
+  if (edges_listed) {
+    edge_list.remove_if(deleted);
+  }
+  for (auto &v : vertex_data) {
+    if (v->listed) v->neighbors.remove_if(deleted);
+  }
+  for (size_t j = i; j < vertices.size(); j++) {
+    vertex_index[vertices[j]] = j;
+  }
+  adjacency = nullptr;
 }
 
 // Print a graph
 std::ostream &operator<<(std::ostream &out, const Graph &graph) {
   // out << "Vertices: " << "\n";
-  std::list<int>::const_iterator it;
+  std::vector<int>::const_iterator it;
   for (it = graph.vertices.begin(); it != graph.vertices.end(); ++it) {
     out << *it << ", ";
   }
@@ -246,134 +525,80 @@ std::ostream &operator<<(std::ostream &out, const Graph &graph) {
 
 // Minimum spanning tree
 double Graph::MST(std::list<std::shared_ptr<Edge>> &edges) const {
-  std::unordered_map<int, bool> inTree;
-  std::unordered_map<int, double> key;
-  std::unordered_map<int, std::shared_ptr<Edge>> edge_keys;
-  size_t numInTree = 0;
-  double weightTree = 0;
-
-  // initialize all vertices
-  for (auto i : vertices) {
-    key[i] = INT_MAX, inTree[i] = false, edge_keys[i] = NULL;
-  }
-
-  // add first vertex
-  key[vertices.front()] = 0;
-
-  // while not all vertices are in the tree
-  while (numInTree < vertices.size()) {
-    // find vertex with min key
-    double min = INT_MAX;
-    int min_v;
-
-    for (auto v : vertices) {
-      if ((inTree[v] == false) && (key[v] < min)) {
-        min = key[v], min_v = v;
-      }
-    }
-
-    // add min vertex to tree and edge
-    inTree[min_v] = true;
-    if (edge_keys[min_v] != NULL) {
-      edges.push_back(edge_keys[min_v]);
-      weightTree += edge_keys[min_v]->getWeight();
-    }
-
-    // update key values
-    for (auto e : getVertex(min_v)->getIncEdges()) {
-      int u = e->getOther(min_v);
-      if (e->getWeight() < key[u]) {
-        key[u] = e->getWeight();
-        edge_keys[u] = e;
-      }
-    }
-    numInTree += 1;
-  }
-
-  return weightTree;
+  return GraphView(*this).MST(edges);
 }
 
 // Calculate tour length
 double getTourLength(const Graph &G, const std::vector<int> &tour) {
-  int n = tour.size();
-  double l = 0;
-  for (size_t i = 0; i < tour.size() - 1; i++) {
-    double w = shortestPath(G, tour[i], tour[i + 1]);
-    l += w;
-  }
-  l += shortestPath(G, tour[n - 1], tour[0]);
-  return l;
+  ShortestPaths paths(G);
+  return getTourLength(paths, tour);
 }
 
 // DFS
-void DFS(std::list<std::shared_ptr<Edge>> &edges,
-         std::unordered_map<int, bool> &visited, std::vector<int> &tour,
-         int v) {
+// Iterative, with the place of the next edge of each vertex on the stack, so it
+// visits the vertices in the same order as a recursive one
+void DFS(const Adjacency &adj, const std::vector<EdgeRecord> &records,
+         const std::vector<int> &ids, std::vector<char> &visited,
+         std::vector<int> &tour, int v) {
   // Mark v as visited and add to tour
+  std::vector<std::pair<uint32_t, uint32_t>> stack = {
+      {static_cast<uint32_t>(v), adj.offsets[v]}};
   visited[v] = true;
-  tour.push_back(v);
-
-  // Iterate through edges
-  for (auto e : edges) {
-    if ((e->getTail() == v) || (e->getHead() == v)) {
-      int u = e->getOther(v);
-      if (visited[u] == false) {
-        DFS(edges, visited, tour, u);
-      }
+  tour.push_back(ids[v]);
+
+  while (!stack.empty()) {
+    uint32_t u = stack.back().first;
+    uint32_t &k = stack.back().second;
+    if (k == adj.offsets[u + 1]) {
+      stack.pop_back();
+      continue;
+    }
+
+    // Go on to the other end of the next edge if it is new
+    const EdgeRecord &r = records[adj.edges[k++]];
+    uint32_t w = r.head == u ? r.tail : r.head;
+    if (!visited[w]) {
+      visited[w] = true;
+      tour.push_back(ids[w]);
+      stack.push_back({w, adj.offsets[w]});
     }
   }
 }
 
-// Find ordered list of tour given a tree of edges
-std::vector<int> tourList(std::list<std::shared_ptr<Edge>> &edges) {
-  // Find starting vertex and create bool unordered_map
-  int v = edges.front()->getHead();
-  std::unordered_map<int, bool> visited;
-  for (auto e : edges) {
-    visited[e->getHead()] = false, visited[e->getTail()] = false;
+// Find ordered list of tour given a tree of edges, or of the trees of a forest
+// one after the other
+std::vector<int> tourList(const std::list<std::shared_ptr<Edge>> &edges) {
+  // Number the vertices in the order they appear and keep the edges by their
+  // ends
+  std::unordered_map<int, int> index;
+  std::vector<int> ids;
+  std::vector<EdgeRecord> records;
+  records.reserve(edges.size());
+  auto indexOf = [&](int id) {
+    auto it = index.emplace(id, ids.size());
+    if (it.second) ids.push_back(id);
+    return static_cast<uint32_t>(it.first->second);
+  };
+  for (const auto &e : edges) {
+    uint32_t h = indexOf(e->getHead());
+    uint32_t t = indexOf(e->getTail());
+    records.push_back(EdgeRecord{h, t, e->getWeight()});
   }
+  Adjacency adj = makeAdjacency(records, ids.size());
+  std::vector<char> visited(ids.size(), false);
   std::vector<int> tour;
+  tour.reserve(ids.size());
 
-  DFS(edges, visited, tour, v);
+  // Start from the first edge of each tree
+  for (const auto &r : records) {
+    if (!visited[r.head]) {
+      DFS(adj, records, ids, visited, tour, r.head);
+    }
+  }
   return tour;
 }
 
 // Find length of shortest path from i to j in G
 double shortestPath(const Graph &G, int i, int j) {
-  // Set up distance unordered_maps
-  std::unordered_map<int, double> distances;
-  std::unordered_map<int, bool> setDist;
-  for (auto v : G.getVertices()) {
-    setDist[v] = false;
-    distances[v] = INT_MAX;
-  }
-
-  // Start at i
-  distances[i] = 0;
-
-  // While j is not set
-  while (setDist[j] == false) {
-    // Find min unmarked
-    int minIndex = INT_MAX, u = 0;
-    for (auto v : G.getVertices()) {
-      if ((setDist[v] == false) && (distances[v] < minIndex)) {
-        u = v;
-      }
-    }
-
-    // Set distances of u
-    setDist[u] = true;
-
-    // Iterate through incident edges to u
-    if (distances[u] != INT_MAX) {
-      for (auto e : G.getVertex(u)->getIncEdges()) {
-        int v = e->getOther(u);
-        double w = e->getWeight();
-        if ((setDist[v] == false) && (distances[v] > distances[u] + w)) {
-          distances[v] = distances[u] + w;
-        }
-      }
-    }
-  }
-  return distances[j];
+  return ShortestPaths(G).distance(i, j);
 }
@@ -0,0 +1,406 @@
+#include "graph_view.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "indexed_heap.h"
+
+// View of all of G
+GraphView::GraphView(const Graph &G) {
+  graph = &G;
+  whole = true;
+  W = G.getWeight();
+  P = G.getPrize();
+}
+
+// subgraph view constructors
+GraphView::GraphView(const GraphView &G, const std::list<int> &S) {
+  graph = &G.getGraph();
+  addSubgraph(S);
+}
+
+GraphView::GraphView(const GraphView &G, const VertexRange &S) {
+  graph = &G.getGraph();
+  addSubgraph(S);
+}
+
+template <typename Vertices>
+void GraphView::addSubgraph(const Vertices &S) {
+  whole = false;
+  W = 0;
+  P = 0;
+  // add vertices in S
+  vertices.reserve(S.size());
+  indices.reserve(S.size());
+  positions.assign(graph->getVertexIds().size(), -1);
+  for (auto x : S) {
+    int i = graph->getIndex(x);
+    P += graph->getVertexPrize(x);
+    positions[i] = vertices.size();
+    vertices.push_back(x);
+    indices.push_back(i);
+  }
+
+  // add edges with both endpts in S. When S is small next to G they are found
+  // from their heads and put back in the order of G, which drops the second
+  // copy of a loop too, as a loop is at its vertex twice.
+  const Adjacency &adj = graph->getAdjacency();
+  const std::vector<EdgeRecord> &records = graph->getEdgeRecords();
+  std::vector<uint32_t> kept;
+  size_t degrees = 0;
+  for (auto i : indices) {
+    degrees += adj.offsets[i + 1] - adj.offsets[i];
+  }
+  if (degrees < records.size()) {
+    for (auto i : indices) {
+      for (uint32_t k = adj.offsets[i]; k < adj.offsets[i + 1]; k++) {
+        const EdgeRecord &r = records[adj.edges[k]];
+        if ((r.head == static_cast<uint32_t>(i)) && (positions[r.tail] >= 0)) {
+          kept.push_back(adj.edges[k]);
+        }
+      }
+    }
+    std::sort(kept.begin(), kept.end());
+    kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+  } else {
+    for (uint32_t k = 0; k < records.size(); k++) {
+      if ((positions[records[k].head] >= 0) &&
+          (positions[records[k].tail] >= 0)) {
+        kept.push_back(k);
+      }
+    }
+  }
+
+  for (auto k : kept) {
+    double w = records[k].weight;
+    W += w < 0 ? -w : w;
+  }
+  edge_indices = std::move(kept);
+}
+
+// Return the edge pointers, made on first use for a subgraph view. Threads
+// reading the view may make them at the same time, then one set is kept.
+std::vector<std::shared_ptr<Edge>> const &GraphView::getEdgePtrs() const {
+  if (whole) {
+    return graph->getEdgePtrs();
+  }
+  std::shared_ptr<const std::vector<std::shared_ptr<Edge>>> made =
+      std::atomic_load(&edges);
+  if (made != nullptr) {
+    return *made;
+  }
+  auto ptrs = std::make_shared<std::vector<std::shared_ptr<Edge>>>();
+  ptrs->reserve(edge_indices.size());
+  for (auto k : edge_indices) {
+    ptrs->push_back(graph->getEdgePtr(k));
+  }
+  std::shared_ptr<const std::vector<std::shared_ptr<Edge>>> expected;
+  made = ptrs;
+  if (!std::atomic_compare_exchange_strong(&edges, &expected, made)) {
+    made = expected;
+  }
+  return *made;
+}
+
+// Check if a vertex is in the view
+bool GraphView::hasVertex(int id) const {
+  int i = graph->findIndex(id);
+  return (i >= 0) && (getPosition(i) >= 0);
+}
+
+// The adjacency of graph for all of it. A subgraph view has its edges in the
+// order of graph, so counting the ends at each position and placing the edges
+// in order gives them in the same order as the adjacency of graph, in time
+// linear in the size of the view.
+const Adjacency &GraphView::positionAdjacency(Adjacency *local) const {
+  if (whole) {
+    return graph->getAdjacency();
+  }
+  const std::vector<EdgeRecord> &records = graph->getEdgeRecords();
+  size_t n = vertices.size();
+  local->offsets.assign(n + 1, 0);
+  for (auto k : edge_indices) {
+    const EdgeRecord &r = records[k];
+    if (r.head == r.tail) continue;
+    local->offsets[positions[r.head] + 1]++;
+    local->offsets[positions[r.tail] + 1]++;
+  }
+  for (size_t v = 0; v < n; v++) {
+    local->offsets[v + 1] += local->offsets[v];
+  }
+  local->edges.resize(local->offsets.back());
+  std::vector<uint32_t> next(local->offsets.begin(), local->offsets.end() - 1);
+  for (auto k : edge_indices) {
+    const EdgeRecord &r = records[k];
+    if (r.head == r.tail) continue;
+    local->edges[next[positions[r.head]]++] = k;
+    local->edges[next[positions[r.tail]]++] = k;
+  }
+  return *local;
+}
+
+// Minimum spanning tree by Prim's algorithm on the positions of the view
+double GraphView::MST(std::list<std::shared_ptr<Edge>> &edges) const {
+  if (graph->getCoordinates() != nullptr) {
+    return euclideanMST(edges);
+  }
+  // Scanning for the min key takes n steps per vertex, a heap about log n per
+  // edge
+  size_t n = getVertexIds().size();
+  if (getEdgeCount() * std::log2(n + 1) < n * n) {
+    return sparseMST(edges);
+  }
+  Adjacency local;
+  const Adjacency &adj = positionAdjacency(&local);
+  const std::vector<EdgeRecord> &records = graph->getEdgeRecords();
+  std::vector<double> key(n, INT_MAX);
+  std::vector<char> inTree(n, false);
+  std::vector<int> edge_keys(n, -1);
+  double weightTree = 0;
+  if (n == 0) {
+    return weightTree;
+  }
+
+  // add first vertex
+  key[0] = 0;
+
+  // while not all vertices are in the tree
+  for (size_t numInTree = 0; numInTree < n; numInTree++) {
+    // find vertex with min key, or the first one left if none is reached
+    int min_v = -1;
+    for (size_t v = 0; v < n; v++) {
+      if ((inTree[v] == false) && ((min_v < 0) || (key[v] < key[min_v]))) {
+        min_v = v;
+      }
+    }
+
+    // add min vertex to tree and edge
+    inTree[min_v] = true;
+    if (edge_keys[min_v] >= 0) {
+      edges.push_back(graph->getEdgePtr(edge_keys[min_v]));
+      weightTree += records[edge_keys[min_v]].weight;
+    }
+
+    // update key values
+    uint32_t i = getIndex(min_v);
+    for (uint32_t k = adj.offsets[min_v]; k < adj.offsets[min_v + 1]; k++) {
+      const EdgeRecord &r = records[adj.edges[k]];
+      int u = getPosition(r.head == i ? r.tail : r.head);
+      if (r.weight < key[u]) {
+        key[u] = r.weight;
+        edge_keys[u] = adj.edges[k];
+      }
+    }
+  }
+
+  return weightTree;
+}
+
+// Prim's algorithm as above with the vertices left in a heap by key and
+// position, so the vertex taken next is the same and so is the tree
+double GraphView::sparseMST(std::list<std::shared_ptr<Edge>> &edges) const {
+  Adjacency local;
+  const Adjacency &adj = positionAdjacency(&local);
+  const std::vector<EdgeRecord> &records = graph->getEdgeRecords();
+  size_t n = getVertexIds().size();
+  std::vector<double> key(n, INT_MAX);
+  std::vector<int> edge_keys(n, -1);
+  double weightTree = 0;
+  if (n == 0) {
+    return weightTree;
+  }
+
+  // add first vertex
+  key[0] = 0;
+  IndexedMinHeap<std::pair<double, int>> heap(n);
+  std::vector<std::pair<std::pair<double, int>, int>> items;
+  items.reserve(n);
+  for (int v = 0; v < static_cast<int>(n); v++) {
+    items.push_back({{key[v], v}, v});
+  }
+  heap.assign(std::move(items));
+
+  // while not all vertices are in the tree
+  while (!heap.empty()) {
+    // add min vertex to tree and edge
+    int min_v = heap.top();
+    heap.pop();
+    if (edge_keys[min_v] >= 0) {
+      edges.push_back(graph->getEdgePtr(edge_keys[min_v]));
+      weightTree += records[edge_keys[min_v]].weight;
+    }
+
+    // update key values of the vertices left
+    uint32_t i = getIndex(min_v);
+    for (uint32_t k = adj.offsets[min_v]; k < adj.offsets[min_v + 1]; k++) {
+      const EdgeRecord &r = records[adj.edges[k]];
+      int u = getPosition(r.head == i ? r.tail : r.head);
+      if (!heap.contains(u)) continue;
+      if (r.weight < key[u]) {
+        key[u] = r.weight;
+        edge_keys[u] = adj.edges[k];
+        heap.set(u, {key[u], u});
+      }
+    }
+  }
+
+  return weightTree;
+}
+
+// Prim's algorithm as above with the edges from the new vertex worked out
+// from the coordinates. There is one edge between two vertices, so the order
+// of the updates does not matter and the tree is the same.
+double GraphView::euclideanMST(std::list<std::shared_ptr<Edge>> &edges) const {
+  const Coordinates &xy = *graph->getCoordinates();
+  const std::vector<int> &ids = getVertexIds();
+  size_t n = ids.size();
+  std::vector<double> key(n, INT_MAX);
+  std::vector<char> inTree(n, false);
+  std::vector<int> parent(n, -1);
+  double weightTree = 0;
+  if (n == 0) {
+    return weightTree;
+  }
+
+  // coordinates by position, vertices without any have no edges
+  std::vector<int> xs(n), ys(n);
+  std::vector<char> placed(n);
+  for (size_t v = 0; v < n; v++) {
+    placed[v] = xy.has(ids[v]);
+    if (placed[v]) xs[v] = xy.x[ids[v]], ys[v] = xy.y[ids[v]];
+  }
+  std::vector<double> row(n);
+
+  // add first vertex
+  key[0] = 0;
+
+  // while not all vertices are in the tree
+  for (size_t numInTree = 0; numInTree < n; numInTree++) {
+    // find vertex with min key, or the first one left if none is reached
+    int min_v = -1;
+    for (size_t v = 0; v < n; v++) {
+      if ((inTree[v] == false) && ((min_v < 0) || (key[v] < key[min_v]))) {
+        min_v = v;
+      }
+    }
+
+    // add min vertex to tree and edge
+    inTree[min_v] = true;
+    if (parent[min_v] >= 0) {
+      int h = std::max(ids[min_v], ids[parent[min_v]]);
+      int t = std::min(ids[min_v], ids[parent[min_v]]);
+      edges.push_back(std::make_shared<Edge>(h, t, key[min_v]));
+      weightTree += key[min_v];
+    }
+    if (!placed[min_v]) continue;
+
+    // update key values from one row of distances
+    const int x0 = xs[min_v], y0 = ys[min_v];
+    for (size_t v = 0; v < n; v++) {
+      int dx = xs[v] - x0, dy = ys[v] - y0;
+      row[v] = std::sqrt(dx * dx + dy * dy);
+    }
+    for (size_t v = 0; v < n; v++) {
+      if ((inTree[v] == false) && placed[v] && (row[v] < key[v])) {
+        key[v] = row[v];
+        parent[v] = min_v;
+      }
+    }
+  }
+
+  return weightTree;
+}
+
+// Edges at each position, in order, as offsets into edges. Self loops are left
+// out.
+static void incidence(const std::vector<std::pair<int, int>> &ends, int n,
+                      std::vector<int> *offsets, std::vector<int> *edges) {
+  offsets->assign(n + 1, 0);
+  for (const auto &e : ends) {
+    if (e.first == e.second) continue;
+    (*offsets)[e.first + 1]++;
+    (*offsets)[e.second + 1]++;
+  }
+  for (int i = 0; i < n; i++) (*offsets)[i + 1] += (*offsets)[i];
+  edges->resize(offsets->back());
+  std::vector<int> next(offsets->begin(), offsets->end() - 1);
+  for (size_t k = 0; k < ends.size(); k++) {
+    if (ends[k].first == ends[k].second) continue;
+    (*edges)[next[ends[k].first]++] = k;
+    (*edges)[next[ends[k].second]++] = k;
+  }
+}
+
+// Nearest edges of G, made from scratch
+static NearestEdges makeNearestEdges(const GraphView &G, int k) {
+  const std::vector<EdgeRecord> &records = G.getGraph().getEdgeRecords();
+  size_t m = G.getEdgeCount();
+  NearestEdges nearest;
+  nearest.k = k;
+  nearest.ends.reserve(m);
+  for (size_t e = 0; e < m; e++) {
+    const EdgeRecord &r = records[G.getEdgeIndex(e)];
+    nearest.ends.emplace_back(G.getPosition(r.head), G.getPosition(r.tail));
+  }
+  const auto &ends = nearest.ends;
+  const auto &offsets = nearest.offsets;
+  auto &incident = nearest.incident;
+  incidence(ends, G.getVertexIds().size(), &nearest.offsets, &incident);
+
+  auto weight = [&](int e) {
+    double w = records[G.getEdgeIndex(e)].weight;
+    return std::isnan(w) ? INFINITY : w;
+  };
+  auto closer = [&](int a, int b) { return weight(a) < weight(b); };
+  std::vector<char> &kept = nearest.kept;
+  kept.assign(m, false);
+  int n = offsets.size() - 1;
+
+  // The tree by Prim's algorithm, so the kept edges join the same vertices as
+  // G even where the vertices are in clusters
+  std::vector<double> key(n, INFINITY);
+  std::vector<int> tree_edge(n, -1);
+  std::vector<char> in_tree(n, false);
+  for (int added = 0; added < n; added++) {
+    int u = -1;
+    for (int v = 0; v < n; v++) {
+      if (!in_tree[v] && (u < 0 || key[v] < key[u])) u = v;
+    }
+    in_tree[u] = true;
+    if (tree_edge[u] >= 0) kept[tree_edge[u]] = true;
+    for (int j = offsets[u]; j < offsets[u + 1]; j++) {
+      int e = incident[j];
+      int v = ends[e].first == u ? ends[e].second : ends[e].first;
+      if (!in_tree[v] && weight(e) < key[v]) {
+        key[v] = weight(e);
+        tree_edge[v] = e;
+      }
+    }
+  }
+
+  // Picking the k nearest reorders the edges at each vertex, so it works on a
+  // copy and leaves incident in order
+  std::vector<int> order(incident);
+  for (int v = 0; v < n; v++) {
+    auto begin = order.begin() + offsets[v];
+    auto end = order.begin() + offsets[v + 1];
+    if (begin == end) continue;
+    auto last = end - begin > k ? begin + k - 1 : end - 1;
+    std::nth_element(begin, last, end, closer);
+    for (auto it = begin; it != end; ++it) {
+      if (records[G.getEdgeIndex(*it)].weight <= weight(*last)) {
+        kept[*it] = true;
+      }
+    }
+  }
+  return nearest;
+}
+
+std::shared_ptr<const NearestEdges> GraphView::getNearestEdges(int k) const {
+  std::shared_ptr<const NearestEdges> made = std::atomic_load(&nearest);
+  if ((made == nullptr) || (made->k != k)) {
+    made = std::make_shared<NearestEdges>(makeNearestEdges(*this, k));
+    std::atomic_store(&nearest, made);
+  }
+  return made;
+}
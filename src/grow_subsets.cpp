@@ -1,13 +1,13 @@
 #include "grow_subsets.h"
 
 // Linear search through subsets to find next subset which goes tight
-std::pair<double, std::shared_ptr<Subset>> GrowSubsets::minSetTime() const {
+std::pair<double, Subset*> GrowSubsets::minSetTime() const {
   double time_s = INT_MAX;
-  std::shared_ptr<Subset> min_s = nullptr;
+  Subset* min_s = nullptr;
   for (const auto& s : subsets_) {
     if (!s->getActive()) continue;
 
-    double tight_time = lin_s_.at(s).first.t_minus;
+    double tight_time = lin_s_[s->getId()].first.t_minus;
     if (tight_time < time_s - eps_) {  // break ties by slope
       time_s = tight_time;
       min_s = s;
@@ -16,86 +16,168 @@ std::pair<double, std::shared_ptr<Subset>> GrowSubsets::minSetTime() const {
   return std::make_pair(time_s, min_s);
 }
 
+// Representative of the set containing dense vertex v
+inline int GrowSubsets::setOf(int v) { return vertex_sets_.find(v); }
+
+// Representative of the set holding the vertices of subset s
+inline int GrowSubsets::setOf(Subset* s) {
+  return setOf(vertex_index_.at(s->getVertices().front()));
+}
+
+void GrowSubsets::refreshSetFlags(Subset* s) {
+  set_flags_[setOf(s)] =
+      (s->getActive() ? kSubsetActive : 0) | (s->getTied() ? kSubsetTied : 0);
+}
+
+EdgeFunctions GrowSubsets::scanEdgeFunctions(size_t i) {
+  EdgeFunctions e = edge_functions_[i];
+  e.p1 = set_subsets_[setOf(edge_ends_[i].first)];
+  e.p2 = set_subsets_[setOf(edge_ends_[i].second)];
+  return e;
+}
+
+Subset* GrowSubsets::mergeSubsets(Subset* S1, Subset* S2, int e) {
+  std::shared_ptr<Edge> edge = graph_->getEdgePtr(e);
+  std::shared_ptr<Edge> alt =
+      alt_e_ == e ? edge : alt_e_ >= 0 ? graph_->getEdgePtr(alt_e_) : nullptr;
+  return arena_.make(S1, S2, edge, alt);
+}
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::shareRoots() const {
+  std::list<std::shared_ptr<Subset>> roots;
+  for (auto s : subsets_) roots.push_back(arena_.share(s));
+  return roots;
+}
+
 // Linear search through edges to find next edge which goes tight
-std::pair<double, EdgeFunctions> GrowSubsets::minEdgeTime() const {
+std::pair<double, EdgeFunctions> GrowSubsets::minEdgeTime() {
   double time_e = INT_MAX;
-  const EdgeFunctions* optimizer = nullptr;
-  for (const auto& e : edge_functions_) {
-    if (!e.p1->getActive() && !e.p2->getActive()) continue;
-    if (e.p1 == e.p2) continue;
+  int optimizer = -1, winner = -1;
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    int p1 = setOf(edge_ends_[i].first), p2 = setOf(edge_ends_[i].second);
+    bool active1 = set_flags_[p1] & kSubsetActive;
+    bool active2 = set_flags_[p2] & kSubsetActive;
+    if (!active1 && !active2) continue;
+    if (p1 == p2) continue;
 
     // Time to go tight for edge e
-    double tight_time =
-        e.first.t_minus / (int(e.p1->getActive()) + int(e.p2->getActive()));
+    int ends = int(active1) + int(active2);
+    double tight_time = edge_functions_[i].first.t_minus / ends;
+    if (record_) {
+      recordCandidate(tight_time, minusSlope(edge_functions_[i].first) / ends);
+    }
 
-    // If new min store constant reference (avoid copying until loop finishes)
+    // If new min store its index (avoid copying until loop finishes)
     if (tight_time < time_e - eps_) {
       time_e = tight_time;
-      optimizer = &e;
+      optimizer = i;
+      winner = int(candidate_times_.size()) - 1;
     }
   }
+  if (record_) keepMinimum(winner);
 
   EdgeFunctions min_e_functions;
-  if (optimizer != nullptr) {
-    min_e_functions = *optimizer;
-  }
+  if (optimizer >= 0) min_e_functions = scanEdgeFunctions(optimizer);
   return std::make_pair(time_e, min_e_functions);
 }
 
-void GrowSubsets::resolveTies(const EdgeFunctions& min_e_functions) {
+// Linear search through edges between the same subsets as min_e_functions
+const EdgeFunctions* GrowSubsets::minTiedEdge(
+    const EdgeFunctions& min_e_functions) {
   // Find event time for min_e at lambda*(1+tieeps)
   double factor = 1.0 / (int(min_e_functions.p1->getActive()) +
                          int(min_e_functions.p2->getActive()));
   double time_p = factor * min_e_functions.second.t_plus;
 
   // Find minimum tied edge between same subsets at lambda*(1+tieeps)
+  int min_p1 = setOf(min_e_functions.p1), min_p2 = setOf(min_e_functions.p2);
   const EdgeFunctions* optimizer = nullptr;
-  for (const auto& e : edge_functions_) {
-    if (((e.p1 == min_e_functions.p1) && (e.p2 == min_e_functions.p2)) ||
-        ((e.p1 == min_e_functions.p2) && (e.p2 == min_e_functions.p1))) {
+  int winner = -1, own = -1;
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    const auto& e = edge_functions_[i];
+    int p1 = setOf(edge_ends_[i].first), p2 = setOf(edge_ends_[i].second);
+    if (((p1 == min_p1) && (p2 == min_p2)) ||
+        ((p1 == min_p2) && (p2 == min_p1))) {
       // Time to go tight for edge e
       double tight_time = factor * e.second.t_plus;
+      if (record_) {
+        if (e.edge == min_e_functions.edge) own = candidate_times_.size();
+        recordCandidate(tight_time, factor * plusSlope(e.second));
+      }
 
       // If new min at lambda*(1+tieeps)
       if (tight_time < time_p - eps_) {
         optimizer = &e;
         time_p = tight_time;
+        winner = int(candidate_times_.size()) - 1;
       }
     }
   }
-  if (optimizer != nullptr) {
-    lin_val_p2_ = {factor * optimizer->second.t_minus,
-                   factor * optimizer->second.t_plus};
-    alt_e_ = optimizer->edge;
+  if (record_) keepMinimum(optimizer != nullptr ? winner : own);
+  return optimizer;
+}
+
+void GrowSubsets::resolveTies(const EdgeFunctions& min_e_functions,
+                              const EdgeFunctions* alt_e_functions,
+                              const LinearFunction& p1_second,
+                              const LinearFunction& p2_second) {
+  // Find event time for min_e at lambda*(1+tieeps)
+  double factor = 1.0 / (int(min_e_functions.p1->getActive()) +
+                         int(min_e_functions.p2->getActive()));
+  double time_p = factor * min_e_functions.second.t_plus;
+
+  // Switch to the minimum tied edge between same subsets at lambda*(1+tieeps)
+  if (alt_e_functions != nullptr) {
+    time_p = factor * alt_e_functions->second.t_plus;
+    lin_val_p2_ = {factor * alt_e_functions->second.t_minus,
+                   factor * alt_e_functions->second.t_plus};
+    alt_e_ = alt_e_functions->edge;
+  }
+
+  if (record_) {
+    const auto& tied_e = alt_e_functions != nullptr ? *alt_e_functions
+                                                    : min_e_functions;
+    double time_slope = factor * plusSlope(tied_e.second);
+    bool active1 = min_e_functions.p1->getActive();
+    bool active2 = min_e_functions.p2->getActive();
+    if (active1) {
+      keepOrder(p1_second.t_plus, plusSlope(p1_second), time_p, time_slope);
+    }
+    if (active2) {
+      keepOrder(p2_second.t_plus, plusSlope(p2_second), time_p, time_slope);
+    }
+    if (active1 && active2) {
+      keepOrder(p1_second.t_plus, plusSlope(p1_second), p2_second.t_plus,
+                plusSlope(p2_second));
+    }
   }
 
   // Find if parents go neutral before the edge at lambda*(1+eps)
   double testp1 = INT_MAX, testp2 = INT_MAX;
   bool tiedp1 = false, tiedp2 = false;
   if (min_e_functions.p1->getActive()) {
-    testp1 = lin_s_[min_e_functions.p1].second.t_plus;
+    testp1 = p1_second.t_plus;
     tiedp1 = (testp1 < time_p - eps_);
     min_e_functions.p1->setTied(tiedp1);
   }
   if (min_e_functions.p2->getActive()) {
-    testp2 = lin_s_[min_e_functions.p2].second.t_plus;
+    testp2 = p2_second.t_plus;
     tiedp2 = (testp2 < time_p - eps_);
     min_e_functions.p2->setTied(tiedp2);
   }
   // P1 ties and P2 is active - edge will go tight next
   if ((tiedp1) && (tiedp2 == false) && (min_e_functions.p2->getActive())) {
-    lin_val_p1_ = lin_s_[min_e_functions.p1].second;
-    lin_val_p2_ =
-        min_e_functions.second - 2 * lin_s_[min_e_functions.p1].second;
+    lin_val_p1_ = p1_second;
+    lin_val_p2_ = min_e_functions.second - 2 * p1_second;
   }
   // P2 ties and P1 is active - edge will go tight next
   else if ((tiedp2) && (tiedp1 == false) && (min_e_functions.p1->getActive())) {
-    lin_val_p1_ = lin_s_[min_e_functions.p2].second;
+    lin_val_p1_ = p2_second;
 
     // Project linear functions into standard coefficients and do the
     // subtraction, then project back
     const auto& e_f = min_e_functions.second;
-    const auto& s_f = lin_s_[min_e_functions.p2].second;
+    const auto& s_f = p2_second;
     double a = e_f.slope(t_minus_, t_plus_) - 2 * s_f.slope(t_minus_, t_plus_);
     double b = e_f.offset(t_minus_, t_plus_) - s_f.offset(t_minus_, t_plus_);
 
@@ -118,38 +200,41 @@ void GrowSubsets::resolveTies(const EdgeFunctions& min_e_functions) {
 }
 
 // ~40% of runtime is spent in this function for large and small problems.
-inline void GrowSubsets::updateEdge(EdgeFunctions* edge) {
-  if (edge->p1->getActive()) edge->first -= lin_val_;
-  if (edge->p2->getActive()) edge->first -= lin_val_;
+inline void GrowSubsets::updateEdge(EdgeFunctions* edge, uint8_t p1_flags,
+                                    uint8_t p2_flags) {
+  if (p1_flags & kSubsetActive) edge->first -= lin_val_;
+  if (p2_flags & kSubsetActive) edge->first -= lin_val_;
 
   // If parent 1 is tied only raise p1 otherwise p1+p2
-  if (edge->p1->getTied()) {
+  if (p1_flags & kSubsetTied) {
     edge->second -= lin_val_p1_;
-  } else if (edge->p1->getActive()) {
+  } else if (p1_flags & kSubsetActive) {
     edge->second -= lin_val_p1_plus_p2_;
   }
 
   // If parent 2 is tied only raise p1 otherwise p1+p2
-  if (edge->p2->getTied()) {
+  if (p2_flags & kSubsetTied) {
     edge->second -= lin_val_p1_;
-  } else if (edge->p2->getActive()) {
+  } else if (p2_flags & kSubsetActive) {
     edge->second -= lin_val_p1_plus_p2_;
   }
 }
 
-inline void GrowSubsets::updateSubsets() {
+void GrowSubsets::updateSubsets() {
+  if (!candidates_.empty()) addEndGrowth();
+
   // Update y_vals and times to go tight
-  for (auto s : subsets_) {
+  for (const auto& s : subsets_) {
     if (!s->getActive()) continue;
 
     s->setY(s->getY() + lin_val_.t_minus);
-    lin_s_[s].first -= lin_val_;
+    lin_s_[s->getId()].first -= lin_val_;
 
     // If tied then only raise first linear amount p1
     if (s->getTied()) {
-      lin_s_[s].second -= lin_val_p1_;
+      lin_s_[s->getId()].second -= lin_val_p1_;
     } else {
-      lin_s_[s].second -= lin_val_p1_plus_p2_;
+      lin_s_[s->getId()].second -= lin_val_p1_plus_p2_;
     }
   }
 }
@@ -157,38 +242,47 @@ inline void GrowSubsets::updateSubsets() {
 // 25% of runtime is spent in this function for small problems, ~5% for large
 // problems
 inline std::pair<double, EdgeFunctions>
-GrowSubsets::updateEdgesGivenNeutralSubset(
-    const std::shared_ptr<Subset>& min_s) {
+GrowSubsets::updateEdgesGivenNeutralSubset(Subset* min_s) {
   double time_e = INT_MAX;
-  const EdgeFunctions* optimizer = nullptr;
+  int optimizer = -1, winner = -1;
+  int neutral = setOf(min_s);
   // Feels pretty optimized unless we go for a different data structure
-  for (auto& e : edge_functions_) {
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    auto& e = edge_functions_[i];
+    int p1 = setOf(edge_ends_[i].first), p2 = setOf(edge_ends_[i].second);
+    uint8_t flags1 = set_flags_[p1], flags2 = set_flags_[p2];
+
     // Part 1: Update treating min_s as active
-    if (!e.p1->getActive() && !e.p2->getActive()) continue;
-    updateEdge(&e);
+    if (!(flags1 & kSubsetActive) && !(flags2 & kSubsetActive)) continue;
+    updateEdge(&e, flags1, flags2);
 
-    if (e.p1 != e.p2) {
+    if (p1 != p2) {
       // Part 2: Search assuming min_s is inactive
-      int factor_inverse = int(e.p1->getActive()) + int(e.p2->getActive());
-      if (e.p1 == min_s || e.p2 == min_s) {
+      int factor_inverse =
+          int(flags1 & kSubsetActive) + int(flags2 & kSubsetActive);
+      if (p1 == neutral || p2 == neutral) {
         factor_inverse -= 1;
         if (factor_inverse == 0) continue;
       }
 
       // Time to go tight for edge e
       double tight_time = e.first.t_minus / factor_inverse;
+      if (record_) {
+        recordCandidate(tight_time, minusSlope(e.first) / factor_inverse);
+      }
 
-      // If new min store constant reference (avoid copying until loop
-      // finishes)
+      // If new min store its index (avoid copying until loop finishes)
       if (tight_time < time_e - eps_) {
         time_e = tight_time;
-        optimizer = &e;
+        optimizer = i;
+        winner = int(candidate_times_.size()) - 1;
       }
     }
   }
+  if (record_) keepMinimum(winner);
 
   EdgeFunctions min_e_functions;
-  if (optimizer != nullptr) min_e_functions = *optimizer;
+  if (optimizer >= 0) min_e_functions = scanEdgeFunctions(optimizer);
 
   return std::make_pair(time_e, min_e_functions);
 }
@@ -196,42 +290,169 @@ GrowSubsets::updateEdgesGivenNeutralSubset(
 // 25% of runtime is spent in this function for small problems
 // 40% for large problems
 inline std::pair<double, EdgeFunctions> GrowSubsets::updateEdgesGivenTightEdge(
-    const std::shared_ptr<Subset>& S1, const std::shared_ptr<Subset>& S2,
-    const std::shared_ptr<Subset>& S) {
+    Subset* S1, Subset* S2, Subset* S) {
+  // Edges resolve their endpoints before S1 and S2 are united, so endpoints in
+  // either are replaced by S while scanning
+  const int kMerged = -1;
+  int set1 = setOf(S1), set2 = setOf(S2);
+  uint8_t merged_flags =
+      (S->getActive() ? kSubsetActive : 0) | (S->getTied() ? kSubsetTied : 0);
+
   double time_e = INT_MAX;
-  EdgeFunctions min_e_functions;
-  for (auto it = edge_functions_.begin(); it != edge_functions_.end();) {
+  int optimizer = -1, winner = -1;
+  for (size_t i = 0; i < edge_functions_.size();) {
+    auto& e = edge_functions_[i];
+    int p1 = setOf(edge_ends_[i].first), p2 = setOf(edge_ends_[i].second);
+    uint8_t flags1 = set_flags_[p1], flags2 = set_flags_[p2];
+
     // Part 1: Update edges
-    if (it->p1->getActive() || it->p2->getActive()) updateEdge(&(*it));
+    if ((flags1 & kSubsetActive) || (flags2 & kSubsetActive)) {
+      updateEdge(&e, flags1, flags2);
+    }
 
     // Part 2: Update parents and remove if applicable
-    if (it->p1 == S1 || it->p1 == S2) it->p1 = S;
-    if (it->p2 == S1 || it->p2 == S2) it->p2 = S;
-    if (it->p1 == it->p2) {
+    if (p1 == set1 || p1 == set2) p1 = kMerged, flags1 = merged_flags;
+    if (p2 == set1 || p2 == set2) p2 = kMerged, flags2 = merged_flags;
+    if (p1 == p2) {
       // Erase by swapping with last element and popping the back
-      (*it) = edge_functions_.back();
+      e = edge_functions_.back();
       edge_functions_.pop_back();
+      edge_ends_[i] = edge_ends_.back();
+      edge_ends_.pop_back();
 
       // Part 3: Search for min
     } else {
-      if (it->p1->getActive() || it->p2->getActive()) {
+      bool active1 = flags1 & kSubsetActive, active2 = flags2 & kSubsetActive;
+      if (active1 || active2) {
         // Evaluated at lambda * ( 1 - tieeps)
-        double tight_time = it->first.t_minus / (int(it->p1->getActive()) +
-                                                 int(it->p2->getActive()));
+        int ends = int(active1) + int(active2);
+        double tight_time = e.first.t_minus / ends;
+        if (record_) recordCandidate(tight_time, minusSlope(e.first) / ends);
 
         if (tight_time < time_e - eps_) {
           time_e = tight_time;
-          min_e_functions = *it;
+          optimizer = i;
+          winner = int(candidate_times_.size()) - 1;
         }
       }
-      ++it;
+      ++i;
     }
   }
+  if (record_) keepMinimum(winner);
+
+  int merged = vertex_sets_.unite(set1, set2);
+  set_subsets_[merged] = S;
+  set_flags_[merged] = merged_flags;
+
+  EdgeFunctions min_e_functions;
+  if (optimizer >= 0) min_e_functions = scanEdgeFunctions(optimizer);
   return std::make_pair(time_e, min_e_functions);
 }
 
-std::list<std::shared_ptr<Subset>> GrowSubsets::build(const Graph& G,
+inline std::pair<double, EdgeFunctions>
+GrowSubsets::contractEdgesGivenTightEdge(
+    Subset* S1, Subset* S2, Subset* S) {
+  int set1 = setOf(S1), set2 = setOf(S2);
+  uint8_t merged_flags =
+      (S->getActive() ? kSubsetActive : 0) | (S->getTied() ? kSubsetTied : 0);
+
+  // Part 1: Update edges. Find the ones inside S, which die, and the ones from
+  // S1 or S2 to another subset, which may become parallel.
+  std::vector<size_t> dead;
+  std::vector<std::pair<int, size_t>> crossing;
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    int p1 = setOf(edge_ends_[i].first), p2 = setOf(edge_ends_[i].second);
+    uint8_t flags1 = set_flags_[p1], flags2 = set_flags_[p2];
+    if ((flags1 & kSubsetActive) || (flags2 & kSubsetActive)) {
+      updateEdge(&edge_functions_[i], flags1, flags2);
+    }
+
+    bool merged1 = p1 == set1 || p1 == set2;
+    bool merged2 = p2 == set1 || p2 == set2;
+    if (p1 == p2 || (merged1 && merged2)) {
+      dead.push_back(i);
+    } else if (merged1 || merged2) {
+      crossing.emplace_back(merged1 ? p2 : p1, i);
+    }
+  }
+
+  int merged = vertex_sets_.unite(set1, set2);
+  set_subsets_[merged] = S;
+  set_flags_[merged] = merged_flags;
+
+  // Part 2: Fold edges which became parallel and remove the dead ones, then
+  // search for min in the same order as the reference scan
+  removeContractedEdges(dead, foldParallelEdges(crossing));
+  return minEdgeTime();
+}
+
+inline std::pair<double, EdgeFunctions>
+GrowSubsets::sparseEdgesGivenTightEdge(
+    Subset* S1, Subset* S2, Subset* S) {
+  int set1 = setOf(S1), set2 = setOf(S2);
+  uint8_t merged_flags =
+      (S->getActive() ? kSubsetActive : 0) | (S->getTied() ? kSubsetTied : 0);
+
+  // Part 1: Update edges and find the ones inside S, which die
+  std::vector<size_t> dead;
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    int p1 = setOf(edge_ends_[i].first), p2 = setOf(edge_ends_[i].second);
+    uint8_t flags1 = set_flags_[p1], flags2 = set_flags_[p2];
+    if ((flags1 & kSubsetActive) || (flags2 & kSubsetActive)) {
+      updateEdge(&edge_functions_[i], flags1, flags2);
+    }
+
+    bool merged1 = p1 == set1 || p1 == set2;
+    bool merged2 = p2 == set1 || p2 == set2;
+    if (p1 == p2 || (merged1 && merged2)) dead.push_back(i);
+  }
+
+  // Part 2: Find the dropped edges which die with them from the vertices of
+  // the smaller subset. Self loops die at the first merge.
+  std::vector<int> dropped;
+  dropped.swap(self_loops_left_);
+  bool small1 = S1->getVertices().size() <= S2->getVertices().size();
+  int other = small1 ? set2 : set1;
+  for (int v : (small1 ? S1 : S2)->getVertices()) {
+    int i = vertex_index_.at(v);
+    for (int j = nearest_->offsets[i]; j < nearest_->offsets[i + 1]; j++) {
+      int k = nearest_->incident[j];
+      if (candidates_[k]) continue;
+      const auto& ends = nearest_->ends[k];
+      if (setOf(ends.first == i ? ends.second : ends.first) == other) {
+        dropped.push_back(k);
+      }
+    }
+  }
+
+  int merged = vertex_sets_.unite(set1, set2);
+  set_subsets_[merged] = S;
+  set_flags_[merged] = merged_flags;
+
+  // Part 3: Remove the dead edges, then search for min in the same order as
+  // the reference scan
+  removeSparseEdges(dead, dropped);
+  return minEdgeTime();
+}
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::build(const GraphView& G,
                                                       double lambda) {
+  if (engine_ == GrowthEngine::kEdgeScan && neighbors_ > 0) {
+    return buildSparse(G, lambda);
+  }
+  if (engine_ == GrowthEngine::kEdgeScan ||
+      engine_ == GrowthEngine::kContractedEdgeScan) {
+    return buildEdgeScan(G, lambda);
+  }
+  if (engine_ == GrowthEngine::kVectorEdgeScan)
+    return buildVectorScan(G, lambda);
+  return buildLazyDuals(G, lambda);
+}
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::buildEdgeScan(
+    const GraphView& G, double lambda) {
+  graph_ = &G;
+  lambda_ = lambda;
   t_minus_ = lambda * (1 - tieeps_);
   t_plus_ = lambda * (1 + tieeps_);
 
@@ -240,88 +461,154 @@ std::list<std::shared_ptr<Subset>> GrowSubsets::build(const Graph& G,
   // t_minus and t_plus, we might as well store those.
 
   // First create an active subset for each vertex and intialize a_s and b_s
-  for (auto v : G.getVertices()) {
-    int prize = G.getVertex(v)->getPrize();
-    std::shared_ptr<Subset> Sp = std::make_shared<Subset>(v, prize, prize);
-    vertex_subs_[v] = Sp;
+  // A family on n vertices has at most 2n - 1 subsets
+  vertex_sets_.reset(G.getVertexIds().size());
+  lin_s_.resize(2 * G.getVertexIds().size());
+  for (auto v : G.getVertexIds()) {
+    int prize = G.getVertexPrize(v);
+    Subset* Sp = arena_.make(v, prize, prize);
+    vertex_index_[v] = set_subsets_.size();
+    set_subsets_.push_back(Sp);
+    set_flags_.push_back(kSubsetActive);
     subsets_.push_back(Sp);
     double val_at_tminus = 0 * t_minus_ + 0.5 * prize;
     double val_at_tplus = 0 * t_plus_ + 0.5 * prize;
-    lin_s_[Sp] = LinearFunctionPair{{val_at_tminus, val_at_tplus},
-                                    {val_at_tminus, val_at_tplus}};
+    lin_s_[Sp->getId()] = LinearFunctionPair{{val_at_tminus, val_at_tplus},
+                                             {val_at_tminus, val_at_tplus}};
   }
 
-  for (auto e : G.getEdges()) {
-    double val_at_tminus = e->getWeight() * t_minus_ + 0.;
-    double val_at_tplus = e->getWeight() * t_plus_ + 0.;
-    edge_functions_.emplace_back(EdgeFunctions{e,
+  const std::vector<int>& ids = G.getGraph().getVertexIds();
+  for (size_t k = 0; k < G.getEdgeCount(); k++) {
+    if (!candidates_.empty() && !candidates_[k]) continue;
+    const EdgeRecord& e = G.getEdgeRecord(k);
+    double val_at_tminus = e.weight * t_minus_ + 0.;
+    double val_at_tplus = e.weight * t_plus_ + 0.;
+    edge_functions_.emplace_back(EdgeFunctions{int(k),
                                                {val_at_tminus, val_at_tplus},
                                                {val_at_tminus, val_at_tplus},
-                                               vertex_subs_[e->getHead()],
-                                               vertex_subs_[e->getTail()]});
+                                               nullptr,
+                                               nullptr});
+    edge_ends_.emplace_back(vertex_index_.at(ids[e.head]),
+                            vertex_index_.at(ids[e.tail]));
   }
+  if (engine_ == GrowthEngine::kContractedEdgeScan) initContraction();
+  if (!candidates_.empty()) initSparse(G);
 
+  record_ = log_ != nullptr && replay_ == 0 && lambda_lo_ < lambda_hi_;
   auto min_edge = minEdgeTime();
   auto min_e_functions = min_edge.second;
   auto time_e = min_edge.first;
 
-  while (true) {
-    auto min_set = minSetTime();
+  for (size_t event = 0;; event++) {
+    // Events replayed from log_ take the subset going neutral and the tied
+    // edge from it instead of searching for them
+    const GrowthEvent* logged =
+        event < replay_ ? &log_->events[event] : nullptr;
+    record_ = log_ != nullptr && logged == nullptr && lambda_lo_ < lambda_hi_;
+    std::pair<double, Subset*> min_set(INT_MAX, nullptr);
+    if (logged == nullptr) {
+      min_set = minSetTime();
+      if (record_) keepMinSet(min_set.second);
+    } else if (logged->neutral_set >= 0) {
+      min_set.second = set_subsets_[logged->neutral_set];
+      min_set.first = lin_s_[min_set.second->getId()].first.t_minus;
+    }
     auto time_s = min_set.first;  // Time subset goes tight
     auto min_s = min_set.second;  // First subset to go tight
 
     // If nothing to go tight - then algorithm is done
-    if ((min_s == nullptr) && (min_e_functions.edge == nullptr)) {
-      return subsets_;
+    if ((min_s == nullptr) && (min_e_functions.edge < 0)) {
+      if (log_ != nullptr) {
+        log_->lo = lambda_lo_;
+        log_->hi = lambda_hi_;
+      }
+      return shareRoots();
     }
 
     lin_val_ = LinearFunction{0, 0};
     // Update linear functions
-    if (min_s == nullptr || time_e < time_s + eps_) {
+    bool edge_event = logged != nullptr
+                          ? logged->neutral_set < 0
+                          : min_s == nullptr || time_e < time_s + eps_;
+    if (record_ && min_s != nullptr && min_e_functions.edge >= 0) {
+      double ends = int(min_e_functions.p1->getActive()) +
+                    int(min_e_functions.p2->getActive());
+      keepOrder(time_e, minusSlope(min_e_functions.first) / ends, time_s,
+                minusSlope(lin_s_[min_s->getId()].first));
+    }
+    if (edge_event) {
       min_s = nullptr;
       double factor = 1.0 / (int(min_e_functions.p1->getActive()) +
                              int(min_e_functions.p2->getActive()));
       lin_val_ = {factor * min_e_functions.first.t_minus,
                   factor * min_e_functions.first.t_plus};
     } else {
-      min_e_functions.edge = nullptr;
-      lin_val_ = lin_s_.at(min_s).first;
+      min_e_functions.edge = -1;
+      lin_val_ = lin_s_[min_s->getId()].first;
     }
     alt_e_ = min_e_functions.edge;
 
     // If an edge event then we have to check for ties and update lin_vals
     lin_val_p1_ = LinearFunction{0., 0.};
     lin_val_p2_ = LinearFunction{lin_val_.t_minus, lin_val_.t_plus};
-    if (min_e_functions.edge != nullptr) resolveTies(min_e_functions);
+    const EdgeFunctions* alt_e_functions = nullptr;
+    if (min_e_functions.edge >= 0) {
+      if (logged == nullptr) {
+        alt_e_functions = minTiedEdge(min_e_functions);
+      } else if (logged->alt_edge >= 0) {
+        alt_e_functions = &edge_functions_[logged->alt_edge];
+      }
+      resolveTies(min_e_functions, alt_e_functions,
+                  lin_s_[min_e_functions.p1->getId()].second,
+                  lin_s_[min_e_functions.p2->getId()].second);
+      refreshSetFlags(min_e_functions.p1);
+      refreshSetFlags(min_e_functions.p2);
+    }
+    if (record_) {
+      log_->events.push_back(GrowthEvent{
+          min_s != nullptr ? setOf(min_s) : -1,
+          alt_e_functions != nullptr
+              ? int(alt_e_functions - edge_functions_.data())
+              : -1,
+          lambda_lo_, lambda_hi_});
+    }
 
     lin_val_p1_plus_p2_ =
         LinearFunction{lin_val_p1_.t_minus + lin_val_p2_.t_minus,
                        lin_val_p1_.t_plus + lin_val_p2_.t_plus};
     updateSubsets();
 
+    // The edge searches of the update find the next event
+    record_ = log_ != nullptr && event + 1 >= replay_ &&
+              lambda_lo_ < lambda_hi_;
+
     if (min_s != nullptr) {
       auto update_results = updateEdgesGivenNeutralSubset(min_s);
       time_e = update_results.first;
       min_e_functions = update_results.second;
       min_s->setActive(false);
+      refreshSetFlags(min_s);
     } else {
       auto S1 = min_e_functions.p1;
       auto S2 = min_e_functions.p2;
-      std::shared_ptr<Subset> S =
-          std::make_shared<Subset>(S1, S2, min_e_functions.edge, alt_e_);
-      lin_s_[S].first = {lin_s_[S1].first.t_minus + lin_s_[S2].first.t_minus,
-                         lin_s_[S1].first.t_plus + lin_s_[S2].first.t_plus};
-      lin_s_[S].second = {lin_s_[S1].second.t_minus + lin_s_[S2].second.t_minus,
-                          lin_s_[S1].second.t_plus + lin_s_[S2].second.t_plus};
+      auto S = mergeSubsets(S1, S2, min_e_functions.edge);
+      const auto& f1 = lin_s_[S1->getId()];
+      const auto& f2 = lin_s_[S2->getId()];
+      lin_s_[S->getId()] = LinearFunctionPair{
+          {f1.first.t_minus + f2.first.t_minus,
+           f1.first.t_plus + f2.first.t_plus},
+          {f1.second.t_minus + f2.second.t_minus,
+           f1.second.t_plus + f2.second.t_plus}};
 
       subsets_.remove(S1);
       subsets_.remove(S2);
       subsets_.push_back(S);
 
-      // Update vertex_subs_
-      for (auto v : S->getVertices()) vertex_subs_[v] = S;
-
-      auto update_results = updateEdgesGivenTightEdge(S1, S2, S);
+      auto update_results =
+          engine_ == GrowthEngine::kContractedEdgeScan
+              ? contractEdgesGivenTightEdge(S1, S2, S)
+              : !candidates_.empty() ? sparseEdgesGivenTightEdge(S1, S2, S)
+                                     : updateEdgesGivenTightEdge(S1, S2, S);
       time_e = update_results.first;
       min_e_functions = update_results.second;
     }
@@ -0,0 +1,197 @@
+// Variant of the reference edge scan for GrowSubsets which folds parallel
+// edges between the same pair of subsets into one
+#include "grow_subsets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// An edge is only folded into a cheaper one if it is worse by more than this
+// relative margin at both lambda*(1-tieeps) and lambda*(1+tieeps). The scans
+// break near ties (within eps) by position, which such an edge can never win.
+static const double kFoldMargin = 1e-9;
+
+void GrowSubsets::initContraction() {
+  size_t m = edge_functions_.size();
+  ends_by_id_ = edge_ends_;
+  edge_ids_.resize(m);
+  std::iota(edge_ids_.begin(), edge_ids_.end(), 0);
+  ref_edges_ = edge_ids_;
+  ref_positions_ = edge_ids_;
+  fold_last_ = edge_ids_;
+  fold_class_ = edge_ids_;
+  class_positions_ = edge_ids_;
+  class_first_ = edge_ids_;
+  fold_next_.assign(m, -1);
+  class_moved_.assign(m, false);
+  pair_slots_.assign(set_subsets_.size(), -1);
+}
+
+bool GrowSubsets::dominates(const EdgeFunctions& e,
+                            const EdgeFunctions& f) const {
+  auto below = [&](double a, double b) {
+    return b - a > kFoldMargin * (std::fabs(a) + std::fabs(b)) + 8 * eps_;
+  };
+  return below(e.first.t_minus, f.first.t_minus) &&
+         below(e.second.t_plus, f.second.t_plus);
+}
+
+// Edges joining the same subsets get the same updates, so identical functions
+// stay identical and only the first of them in the scan order can be picked
+static bool identical(const EdgeFunctions& e, const EdgeFunctions& f) {
+  return e.first.t_minus == f.first.t_minus &&
+         e.first.t_plus == f.first.t_plus &&
+         e.second.t_minus == f.second.t_minus &&
+         e.second.t_plus == f.second.t_plus;
+}
+
+int GrowSubsets::foldClass(int id) {
+  int c = id;
+  while (c >= 0 && fold_class_[c] != c) c = fold_class_[c];
+  while (id != c) {
+    int next = fold_class_[id];
+    fold_class_[id] = c;
+    id = next;
+  }
+  return c;
+}
+
+void GrowSubsets::foldEdge(int into, int id, bool same_class) {
+  fold_next_[fold_last_[into]] = id;
+  fold_last_[into] = fold_last_[id];
+  fold_class_[id] = same_class ? into : -1;
+  if (same_class && class_positions_[id] < class_positions_[into]) {
+    class_positions_[into] = class_positions_[id];
+    class_first_[into] = class_first_[id];
+    class_moved_[into] = true;
+  }
+}
+
+std::vector<size_t> GrowSubsets::foldParallelEdges(
+    const std::vector<std::pair<int, size_t>>& crossing) {
+  // Cheapest edge to each subset, the first one in order if several are
+  for (const auto& c : crossing) {
+    int& best = pair_slots_[c.first];
+    if (best < 0 || edge_functions_[c.second].first.t_minus <
+                        edge_functions_[best].first.t_minus) {
+      best = c.second;
+    }
+  }
+
+  std::vector<size_t> folded;
+  for (const auto& c : crossing) {
+    size_t best = pair_slots_[c.first];
+    if (c.second == best) continue;
+    const auto& e = edge_functions_[best];
+    const auto& f = edge_functions_[c.second];
+    bool same_class = identical(e, f);
+    if (same_class || dominates(e, f)) {
+      foldEdge(edge_ids_[best], edge_ids_[c.second], same_class);
+      folded.push_back(c.second);
+    }
+  }
+  for (const auto& c : crossing) pair_slots_[c.first] = -1;
+  return folded;
+}
+
+void GrowSubsets::removeContractedEdges(const std::vector<size_t>& dead,
+                                        const std::vector<size_t>& folded) {
+  // Edges folded into a dead edge join the same subsets, so they die with it
+  std::vector<int> positions;
+  for (size_t i : dead) {
+    for (int id = edge_ids_[i]; id >= 0; id = fold_next_[id]) {
+      positions.push_back(ref_positions_[id]);
+    }
+  }
+  std::sort(positions.begin(), positions.end());
+
+  // Remove them from the reference order the way updateEdgesGivenTightEdge
+  // removes them from edge_functions_: the k-th hole below the new size is
+  // filled by the k-th remaining edge from the back. A class of identical
+  // edges is found at its first position.
+  std::vector<int> moved_classes;
+  int size = ref_edges_.size() - positions.size();
+  int back = ref_edges_.size();
+  auto last_dead = positions.rbegin();
+  for (int hole : positions) {
+    if (hole >= size) break;
+    while (true) {
+      back--;
+      if (last_dead == positions.rend() || *last_dead != back) break;
+      ++last_dead;
+    }
+    int id = ref_edges_[back];
+    ref_edges_[hole] = id;
+    ref_positions_[id] = hole;
+    int c = foldClass(id);
+    if (c >= 0 && hole < class_positions_[c]) {
+      class_positions_[c] = hole;
+      class_first_[c] = id;
+      class_moved_[c] = true;
+      moved_classes.push_back(c);
+    }
+  }
+  ref_edges_.resize(size);
+
+  // Drop dead and folded edges from edge_functions_, keeping the rest in
+  // reference order. Classes which moved are taken out and merged back in.
+  struct MovedEdge {
+    int position;
+    EdgeFunctions functions;
+    std::pair<int, int> ends;
+    int id;
+  };
+  std::vector<MovedEdge> moved;
+  size_t kept = 0;
+  auto next_dead = dead.begin();
+  auto next_folded = folded.begin();
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    if (next_dead != dead.end() && *next_dead == i) {
+      ++next_dead;
+      continue;
+    }
+    if (next_folded != folded.end() && *next_folded == i) {
+      ++next_folded;
+      continue;
+    }
+    int id = edge_ids_[i];
+    if (class_moved_[id]) {
+      class_moved_[id] = false;
+      edge_functions_[i].edge = class_first_[id];
+      moved.push_back({class_positions_[id], std::move(edge_functions_[i]),
+                       ends_by_id_[class_first_[id]], id});
+      continue;
+    }
+    if (kept != i) {
+      edge_functions_[kept] = std::move(edge_functions_[i]);
+      edge_ends_[kept] = edge_ends_[i];
+      edge_ids_[kept] = id;
+    }
+    kept++;
+  }
+  for (int c : moved_classes) class_moved_[c] = false;
+
+  std::sort(moved.begin(), moved.end(),
+            [](const MovedEdge& a, const MovedEdge& b) {
+              return a.position < b.position;
+            });
+  size_t size_after = kept + moved.size();
+  for (size_t out = size_after; !moved.empty();) {
+    out--;
+    if (kept > 0 &&
+        class_positions_[edge_ids_[kept - 1]] > moved.back().position) {
+      kept--;
+      edge_functions_[out] = std::move(edge_functions_[kept]);
+      edge_ends_[out] = edge_ends_[kept];
+      edge_ids_[out] = edge_ids_[kept];
+    } else {
+      edge_functions_[out] = std::move(moved.back().functions);
+      edge_ends_[out] = moved.back().ends;
+      edge_ids_[out] = moved.back().id;
+      moved.pop_back();
+    }
+  }
+  edge_functions_.resize(size_after);
+  edge_ends_.resize(size_after);
+  edge_ids_.resize(size_after);
+}
@@ -0,0 +1,107 @@
+// Event log of the reference edge scan for GrowSubsets, see GrowthLog
+#include "grow_subsets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Decisions are only carried over to other lambdas if the values compared
+// differ by more than this fraction of the largest value of the build. That is
+// far above the rounding error a build accumulates, so a build at any lambda
+// in the range makes the same decisions.
+static const double kLogMargin = 1e-9;
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::build(const GraphView& G,
+                                                      double lambda,
+                                                      GrowthLog* log,
+                                                      double lo, double hi) {
+  if (engine_ != GrowthEngine::kEdgeScan) {
+    *log = GrowthLog();
+    return build(G, lambda);
+  }
+
+  // Edge functions start at weight * lambda*(1+tieeps) at most and only
+  // shrink, subset functions start at half their prize
+  double scale = G.getPrize();
+  for (size_t k = 0; k < G.getEdgeCount(); k++) {
+    double w = G.getEdgeRecord(k).weight;
+    scale = std::max(scale, std::fabs(w) * lambda * (1 + tieeps_));
+  }
+  log_margin_ = kLogMargin * scale + 2 * eps_;
+  minus_slope_ = (1 - tieeps_) / (2 * lambda * tieeps_);
+  plus_slope_ = (1 + tieeps_) / (2 * lambda * tieeps_);
+
+  log_ = log;
+  replay_ = log->prefix(lambda);
+  lambda_lo_ = lo;
+  lambda_hi_ = hi;
+  if (replay_ > 0) {
+    lambda_lo_ = std::max(lambda_lo_, log->events[replay_ - 1].lo);
+    lambda_hi_ = std::min(lambda_hi_, log->events[replay_ - 1].hi);
+  }
+  log->events.resize(replay_);
+  clearCandidates();
+  return buildEdgeScan(G, lambda);
+}
+
+void GrowSubsets::keepOrder(double a, double a_slope, double b,
+                            double b_slope) {
+  double d = b - a, d_slope = b_slope - a_slope;
+  // Equal functions come from the same updates (e.g. singletons with the same
+  // prize), so they stay equal and keep being ordered by position
+  if (d == 0 && d_slope == 0) return;
+  if (d < 0) {
+    d = -d;
+    d_slope = -d_slope;
+  }
+  // A near tie could be decided the other way at any other lambda
+  if (d <= log_margin_) {
+    lambda_lo_ = lambda_hi_ = lambda_;
+    return;
+  }
+  // Only divide for the few pairs which narrow the range
+  d -= log_margin_;
+  if (d_slope < 0 && d < (lambda_hi_ - lambda_) * -d_slope) {
+    lambda_hi_ = std::min(lambda_hi_, lambda_ + d / -d_slope);
+  } else if (d_slope > 0 && d < (lambda_ - lambda_lo_) * d_slope) {
+    lambda_lo_ = std::max(lambda_lo_, lambda_ - d / d_slope);
+  }
+}
+
+void GrowSubsets::keepMinimum(int winner) {
+  // Nothing more to narrow once the range is a single lambda
+  if (winner >= 0 && lambda_lo_ < lambda_hi_) {
+    double time = candidate_times_[winner];
+    double slope = candidate_slopes_[winner];
+    // Dropped candidates stay above the winner if their slack covers its
+    // change too, otherwise fall back to the lambda of the build
+    if (dropped_slack_ <= std::fabs(slope) * candidate_width_) {
+      lambda_lo_ = lambda_hi_ = lambda_;
+    }
+    for (size_t i = 0; i < candidate_times_.size(); i++) {
+      if (int(i) == winner) continue;
+      keepOrder(time, slope, candidate_times_[i], candidate_slopes_[i]);
+    }
+  }
+  clearCandidates();
+}
+
+void GrowSubsets::clearCandidates() {
+  candidate_times_.clear();
+  candidate_slopes_.clear();
+  candidate_width_ = std::max(lambda_hi_ - lambda_, lambda_ - lambda_lo_);
+  candidate_min_ = std::numeric_limits<double>::infinity();
+  candidate_min_change_ = 0.;
+  dropped_slack_ = std::numeric_limits<double>::infinity();
+}
+
+void GrowSubsets::keepMinSet(Subset* min_s) {
+  int winner = -1;
+  for (const auto& s : subsets_) {
+    if (!s->getActive()) continue;
+    if (s == min_s) winner = candidate_times_.size();
+    const auto& f = lin_s_[s->getId()].first;
+    recordCandidate(f.t_minus, minusSlope(f));
+  }
+  keepMinimum(winner);
+}
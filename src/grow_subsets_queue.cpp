@@ -0,0 +1,492 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+
+#include "grow_subsets.h"
+
+// Lazy dual engines for GrowSubsets.
+//
+// Every active component grows its dual at the same rate, so instead of
+// subtracting each event's growth from every edge and subset we accumulate it
+// in clock_ and let each component remember the clock when it formed and when
+// it stopped growing. The growth of a vertex is the growth of its current
+// component plus the growth of the components it was merged out of (kept in
+// vertex_base_), which gives the slack of any edge in O(1).
+//
+// kLazyEdgeScan still scans every edge to find the next event, but an event
+// only writes to the merged or neutral components.
+//
+// kEventQueue keys edges and subsets by the absolute time (in units of
+// clock_.first.t_minus) at which they go tight. That time only changes when an
+// endpoint changes activity, so an event only touches the edges incident to
+// components which were or become inactive.
+//
+// The edge scan breaks near ties by the order of edge_functions_ (which is
+// permuted by swap-and-pop removals) and of subsets_. edge_order_ tracks the
+// same permutation so the heaps only have to find the near tied candidates and
+// the winner among them is picked with the same rule as the scan.
+
+namespace {
+
+// Keys this close to the top of a heap are rechecked with the scan's rule
+double nearTieBound(double key) {
+  return key + 1.0e-12 * (1 + std::fabs(key));
+}
+
+// The lazy engines sum the growth in another order than the scan subtracts
+// it, so times the scan sees as tied can differ here by a few ulps of the key
+double tieMargin(double eps, double key) {
+  return eps + 1.0e-14 * std::fabs(key);
+}
+
+}  // namespace
+
+LinearFunctionPair GrowSubsets::growth(int c) const {
+  const auto& comp = components_[c];
+  const auto& now = comp.growing ? clock_ : comp.stop;
+  return LinearFunctionPair{
+      now.first - comp.start.first,
+      now.second - comp.start.second - comp.tie_credit};
+}
+
+LinearFunctionPair GrowSubsets::subsetFunctions(int c) const {
+  auto g = growth(c);
+  const auto& initial = components_[c].initial;
+  return LinearFunctionPair{initial.first - g.first,
+                            initial.second - g.second};
+}
+
+LinearFunctionPair GrowSubsets::edgeSlack(int e) const {
+  const auto& qe = queue_edges_[e];
+  auto g1 = growth(vertex_component_[qe.head]);
+  auto g2 = growth(vertex_component_[qe.tail]);
+  const auto& b1 = vertex_base_[qe.head];
+  const auto& b2 = vertex_base_[qe.tail];
+  return LinearFunctionPair{qe.weight - (b1.first + g1.first) -
+                                (b2.first + g2.first),
+                            qe.weight - (b1.second + g1.second) -
+                                (b2.second + g2.second)};
+}
+
+EdgeFunctions GrowSubsets::edgeFunctions(int e) const {
+  const auto& qe = queue_edges_[e];
+  auto slack = edgeSlack(e);
+  return EdgeFunctions{qe.edge, slack.first, slack.second,
+                       components_[vertex_component_[qe.head]].subset,
+                       components_[vertex_component_[qe.tail]].subset};
+}
+
+double GrowSubsets::edgeTightTime(int e) const {
+  // Same arithmetic as edgeSlack(e).first.t_minus / activeEnds(e)
+  const auto& qe = queue_edges_[e];
+  int ends[2] = {qe.head, qe.tail};
+  double used[2];
+  for (int i = 0; i < 2; i++) {
+    const auto& comp = components_[vertex_component_[ends[i]]];
+    const auto& now = comp.growing ? clock_ : comp.stop;
+    used[i] = vertex_base_[ends[i]].first.t_minus +
+              (now.first.t_minus - comp.start.first.t_minus);
+  }
+  return (qe.weight.t_minus - used[0] - used[1]) / activeEnds(e);
+}
+
+int GrowSubsets::activeEnds(int e) const {
+  int c1 = vertex_component_[queue_edges_[e].head];
+  int c2 = vertex_component_[queue_edges_[e].tail];
+  if (c1 == c2) return 0;
+  return int(components_[c1].growing) + int(components_[c2].growing);
+}
+
+// Picks the winner among the near tied (time, id) candidates the same way the
+// scan does: visiting them in order, a candidate wins if it is more than the
+// tie margin below the current best
+template <typename Order>
+std::pair<double, int> GrowSubsets::breakNearTies(
+    std::vector<std::pair<double, int>>* candidates, Order order) const {
+  // Usually the times are equal and the first one in order wins
+  double lo = INT_MAX, hi = -INT_MAX;
+  for (const auto& c : *candidates) {
+    lo = std::min(lo, c.first);
+    hi = std::max(hi, c.first);
+  }
+  double margin = tieMargin(eps_, lo);
+  if (hi - lo <= 0.5 * margin) {
+    auto first = std::min_element(
+        candidates->begin(), candidates->end(),
+        [&](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+          return order(a.second, b.second);
+        });
+    return *first;
+  }
+
+  std::sort(
+      candidates->begin(), candidates->end(),
+      [&](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        return order(a.second, b.second);
+      });
+  std::pair<double, int> best(INT_MAX, -1);
+  for (const auto& c : *candidates) {
+    if (c.first < best.first - margin) best = c;
+  }
+  return best;
+}
+
+std::pair<double, int> GrowSubsets::scanSubsetEvent() const {
+  // Live components are in subsets_ order
+  double time_s = INT_MAX;
+  int min_s = -1;
+  for (size_t c = 0; c < components_.size(); c++) {
+    if (!components_[c].growing) continue;
+
+    double tight_time = subsetFunctions(c).first.t_minus;
+    if (tight_time < time_s - tieMargin(eps_, time_s)) {
+      time_s = tight_time;
+      min_s = c;
+    }
+  }
+  return std::make_pair(time_s, min_s);
+}
+
+std::pair<double, int> GrowSubsets::scanEdgeEvent() const {
+  double time_e = INT_MAX;
+  int min_e = -1;
+  for (auto e : edge_order_) {
+    if (activeEnds(e) == 0) continue;
+
+    double tight_time = edgeTightTime(e);
+    if (tight_time < time_e - tieMargin(eps_, time_e)) {
+      time_e = tight_time;
+      min_e = e;
+    }
+  }
+  return std::make_pair(time_e, min_e);
+}
+
+std::pair<double, int> GrowSubsets::nextSubsetEvent() const {
+  if (engine_ == GrowthEngine::kLazyEdgeScan) return scanSubsetEvent();
+  if (subset_queue_.empty()) return std::make_pair(double(INT_MAX), -1);
+
+  std::vector<std::pair<double, int>> candidates;
+  double bound = nearTieBound(subset_queue_.topKey().first);
+  subset_queue_.forEachUpTo({bound, INT_MAX}, [&](int c) {
+    candidates.emplace_back(subsetFunctions(c).first.t_minus, c);
+  });
+  // Components are created in subsets_ order
+  return breakNearTies(&candidates, std::less<int>());
+}
+
+std::pair<double, int> GrowSubsets::nextEdgeEvent() const {
+  if (engine_ == GrowthEngine::kLazyEdgeScan) return scanEdgeEvent();
+  if (edge_queue_.empty()) return std::make_pair(double(INT_MAX), -1);
+
+  std::vector<std::pair<double, int>> candidates;
+  double bound = nearTieBound(edge_queue_.topKey().first);
+  edge_queue_.forEachUpTo({bound, INT_MAX}, [&](int e) {
+    candidates.emplace_back(edgeTightTime(e), e);
+  });
+  return breakNearTies(&candidates, [&](int a, int b) {
+    return queue_edges_[a].position < queue_edges_[b].position;
+  });
+}
+
+std::vector<int> GrowSubsets::joiningEdges(int c1, int c2) const {
+  // Only edges incident to the component with fewer edges need checking
+  int c = c1, other = c2;
+  if (components_[c2].incident.size() < components_[c1].incident.size()) {
+    c = c2, other = c1;
+  }
+
+  std::vector<int> joining;
+  for (auto e : components_[c].incident) {
+    int ch = vertex_component_[queue_edges_[e].head];
+    int ct = vertex_component_[queue_edges_[e].tail];
+    if ((ch == c && ct == other) || (ch == other && ct == c)) {
+      joining.push_back(e);
+    }
+  }
+  std::sort(joining.begin(), joining.end(), [&](int a, int b) {
+    return queue_edges_[a].position < queue_edges_[b].position;
+  });
+  return joining;
+}
+
+bool GrowSubsets::minTiedQueueEdge(int min_e, const std::vector<int>& joining,
+                                   EdgeFunctions* alt_e_functions) const {
+  // Find event time for min_e at lambda*(1+tieeps)
+  double factor = 1.0 / activeEnds(min_e);
+  double time_p = factor * edgeSlack(min_e).second.t_plus;
+
+  // Find minimum tied edge between same subsets at lambda*(1+tieeps)
+  int optimizer = -1;
+  for (auto e : joining) {
+    double tight_time = factor * edgeSlack(e).second.t_plus;
+    if (tight_time < time_p - eps_) {
+      optimizer = e;
+      time_p = tight_time;
+    }
+  }
+  if (optimizer < 0) return false;
+  *alt_e_functions = edgeFunctions(optimizer);
+  return true;
+}
+
+void GrowSubsets::freezeComponent(int c) {
+  auto& comp = components_[c];
+  if (!comp.growing) return;
+  comp.subset->setY(growth(c).first.t_minus);
+  comp.stop = clock_;
+  comp.growing = false;
+  subset_queue_.erase(c);
+}
+
+void GrowSubsets::removeEdges(const std::vector<int>& removed) {
+  // Sweeping forward, each removed edge below the new size is overwritten by
+  // the last edge which is kept
+  size_t size = edge_order_.size() - removed.size();
+  std::vector<int> holes;
+  for (auto e : removed) {
+    if (queue_edges_[e].position < int(size)) {
+      holes.push_back(queue_edges_[e].position);
+    }
+    queue_edges_[e].position = -1;
+  }
+
+  size_t back = edge_order_.size();
+  for (auto hole : holes) {
+    int moved;
+    do {
+      moved = edge_order_[--back];
+    } while (queue_edges_[moved].position < 0);
+    edge_order_[hole] = moved;
+    queue_edges_[moved].position = hole;
+  }
+  edge_order_.resize(size);
+}
+
+void GrowSubsets::rekeyEdge(int e) {
+  if (engine_ != GrowthEngine::kEventQueue) return;
+  if (activeEnds(e) == 0) {
+    edge_queue_.erase(e);
+    return;
+  }
+  edge_queue_.set(e, {clock_.first.t_minus + edgeTightTime(e), e});
+}
+
+void GrowSubsets::rekeyIncidentEdges(int c) {
+  auto& incident = components_[c].incident;
+  size_t kept = 0;
+  for (auto e : incident) {
+    const auto& qe = queue_edges_[e];
+    if (vertex_component_[qe.head] == vertex_component_[qe.tail]) continue;
+    rekeyEdge(e);
+    incident[kept++] = e;
+  }
+  incident.resize(kept);
+}
+
+void GrowSubsets::mergeComponents(int c1, int c2,
+                                  const std::vector<int>& joining,
+                                  const EdgeFunctions& min_e_functions) {
+  // Edges of components which were inactive start moving again
+  bool inactive1 = !components_[c1].growing;
+  bool inactive2 = !components_[c2].growing;
+  auto f1 = subsetFunctions(c1), f2 = subsetFunctions(c2);
+  freezeComponent(c1);
+  freezeComponent(c2);
+
+  int c = components_.size();
+  components_.emplace_back();
+  auto& comp = components_.back();
+  auto& comp1 = components_[c1];
+  auto& comp2 = components_[c2];
+  comp.subset =
+      mergeSubsets(comp1.subset, comp2.subset, min_e_functions.edge);
+  comp.initial.first = {f1.first.t_minus + f2.first.t_minus,
+                        f1.first.t_plus + f2.first.t_plus};
+  comp.initial.second = {f1.second.t_minus + f2.second.t_minus,
+                         f1.second.t_plus + f2.second.t_plus};
+  comp.start = clock_;
+  comp.growing = true;
+
+  subsets_.erase(comp1.position);
+  subsets_.erase(comp2.position);
+  comp.position = subsets_.insert(subsets_.end(), comp.subset);
+  if (engine_ == GrowthEngine::kEventQueue) {
+    subset_queue_.set(c,
+                      {clock_.first.t_minus + comp.initial.first.t_minus, c});
+  }
+
+  // Edges inside the new component never go tight. The edge scan drops self
+  // loops on its first merge.
+  for (auto e : joining) edge_queue_.erase(e);
+  if (self_loops_.empty()) {
+    removeEdges(joining);
+  } else {
+    std::vector<int> removed;
+    std::merge(joining.begin(), joining.end(), self_loops_.begin(),
+               self_loops_.end(), std::back_inserter(removed),
+               [&](int a, int b) {
+                 return queue_edges_[a].position < queue_edges_[b].position;
+               });
+    self_loops_.clear();
+    removeEdges(removed);
+  }
+
+  // Fold the growth of the old components into their vertices
+  for (auto old : {c1, c2}) {
+    auto g = growth(old);
+    for (auto v : components_[old].members) {
+      vertex_base_[v].first += g.first;
+      vertex_base_[v].second += g.second;
+      vertex_component_[v] = c;
+    }
+  }
+
+  if (inactive1) rekeyIncidentEdges(c1);
+  if (inactive2) rekeyIncidentEdges(c2);
+
+  // Concatenate vertex and edge lists, appending the smaller ones
+  if (comp1.members.size() < comp2.members.size()) {
+    comp1.members.swap(comp2.members);
+  }
+  comp.members = std::move(comp1.members);
+  comp.members.insert(comp.members.end(), comp2.members.begin(),
+                      comp2.members.end());
+  comp2.members.clear();
+  if (comp1.incident.size() < comp2.incident.size()) {
+    comp1.incident.swap(comp2.incident);
+  }
+  comp.incident = std::move(comp1.incident);
+  comp.incident.insert(comp.incident.end(), comp2.incident.begin(),
+                       comp2.incident.end());
+  comp2.incident.clear();
+}
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::buildLazyDuals(
+    const GraphView& G, double lambda) {
+  graph_ = &G;
+  t_minus_ = lambda * (1 - tieeps_);
+  t_plus_ = lambda * (1 + tieeps_);
+
+  // Create an active component for each vertex. Merges create at most n - 1
+  // more, reserve them so references stay valid.
+  size_t n = G.getVertexIds().size();
+  components_.reserve(2 * n);
+  std::unordered_map<int, int> vertex_index;
+  for (auto v : G.getVertexIds()) {
+    int prize = G.getVertexPrize(v);
+    int c = components_.size();
+    vertex_index[v] = c;
+    vertex_component_.push_back(c);
+
+    components_.emplace_back();
+    auto& comp = components_.back();
+    comp.subset = arena_.make(v, prize, prize);
+    comp.position = subsets_.insert(subsets_.end(), comp.subset);
+    double val_at_tminus = 0 * t_minus_ + 0.5 * prize;
+    double val_at_tplus = 0 * t_plus_ + 0.5 * prize;
+    comp.initial = LinearFunctionPair{{val_at_tminus, val_at_tplus},
+                                      {val_at_tminus, val_at_tplus}};
+    comp.growing = true;
+    comp.members.push_back(c);
+    if (engine_ == GrowthEngine::kEventQueue) {
+      subset_queue_.set(c, {val_at_tminus, c});
+    }
+  }
+  vertex_base_.assign(n, LinearFunctionPair());
+
+  // Self loops never go tight and only take up a position
+  std::vector<std::pair<std::pair<double, int>, int>> edge_keys;
+  const std::vector<int>& ids = G.getGraph().getVertexIds();
+  for (size_t k = 0; k < G.getEdgeCount(); k++) {
+    const EdgeRecord& e = G.getEdgeRecord(k);
+    int head = vertex_index.at(ids[e.head]);
+    int tail = vertex_index.at(ids[e.tail]);
+    int id = queue_edges_.size();
+    double val_at_tminus = e.weight * t_minus_ + 0.;
+    double val_at_tplus = e.weight * t_plus_ + 0.;
+    queue_edges_.push_back(
+        QueueEdge{int(k), {val_at_tminus, val_at_tplus}, head, tail, id});
+    edge_order_.push_back(id);
+    if (head == tail) {
+      self_loops_.push_back(id);
+      continue;
+    }
+    components_[head].incident.push_back(id);
+    components_[tail].incident.push_back(id);
+    edge_keys.push_back({{val_at_tminus / 2, id}, id});
+  }
+  if (engine_ == GrowthEngine::kEventQueue) {
+    edge_queue_.assign(std::move(edge_keys));
+  }
+
+  while (true) {
+    auto min_set = nextSubsetEvent();
+    auto time_s = min_set.first;  // Time subset goes tight
+    auto min_s = min_set.second;  // First subset to go tight
+    auto min_edge = nextEdgeEvent();
+    auto time_e = min_edge.first;
+    auto min_e = min_edge.second;
+
+    // If nothing to go tight - then algorithm is done
+    if (min_s < 0 && min_e < 0) break;
+
+    int c1 = -1, c2 = -1;
+    EdgeFunctions min_e_functions;
+    if (min_s < 0 || (min_e >= 0 && time_e < time_s + eps_)) {
+      min_s = -1;
+      min_e_functions = edgeFunctions(min_e);
+      c1 = vertex_component_[queue_edges_[min_e].head];
+      c2 = vertex_component_[queue_edges_[min_e].tail];
+      double factor = 1.0 / activeEnds(min_e);
+      lin_val_ = {factor * min_e_functions.first.t_minus,
+                  factor * min_e_functions.first.t_plus};
+    } else {
+      min_e = -1;
+      lin_val_ = subsetFunctions(min_s).first;
+    }
+    alt_e_ = min_e_functions.edge;
+
+    // If an edge event then we have to check for ties and update lin_vals
+    lin_val_p1_ = LinearFunction{0., 0.};
+    lin_val_p2_ = LinearFunction{lin_val_.t_minus, lin_val_.t_plus};
+    std::vector<int> joining;
+    if (min_e >= 0) {
+      joining = joiningEdges(c1, c2);
+      EdgeFunctions alt_e_functions;
+      bool has_alt = minTiedQueueEdge(min_e, joining, &alt_e_functions);
+      resolveTies(min_e_functions, has_alt ? &alt_e_functions : nullptr,
+                  subsetFunctions(c1).second, subsetFunctions(c2).second);
+    }
+    lin_val_p1_plus_p2_ =
+        LinearFunction{lin_val_p1_.t_minus + lin_val_p2_.t_minus,
+                       lin_val_p1_.t_plus + lin_val_p2_.t_plus};
+
+    // Grow every active component. Tied components only raise by lin_val_p1_
+    for (auto c : {c1, c2}) {
+      if (c >= 0 && components_[c].growing &&
+          components_[c].subset->getTied()) {
+        components_[c].tie_credit += lin_val_p1_plus_p2_ - lin_val_p1_;
+      }
+    }
+    clock_.first += lin_val_;
+    clock_.second += lin_val_p1_plus_p2_;
+
+    if (min_s >= 0) {
+      freezeComponent(min_s);
+      components_[min_s].subset->setActive(false);
+      rekeyIncidentEdges(min_s);
+    } else {
+      mergeComponents(c1, c2, joining, min_e_functions);
+    }
+  }
+
+  // Record the dual value of the components which never stopped growing
+  for (size_t c = 0; c < components_.size(); c++) {
+    if (components_[c].growing) {
+      components_[c].subset->setY(growth(c).first.t_minus);
+    }
+  }
+  return shareRoots();
+}
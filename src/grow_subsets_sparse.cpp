@@ -0,0 +1,261 @@
+// Variant of the reference edge scan for GrowSubsets which only scans the
+// edges to the nearest neighbors of each vertex, then checks that the dropped
+// edges could not have changed the result
+#include "grow_subsets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// A dropped edge only counts as making no difference if it is worse than the
+// edges it is compared with by more than this relative margin. That is far
+// above the rounding error between its functions in a full scan and the sums
+// missedEdges works them out from.
+static const double kSparseMargin = 1e-9;
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::buildSparse(const GraphView& G,
+                                                            double lambda) {
+  std::shared_ptr<const NearestEdges> nearest = G.getNearestEdges(neighbors_);
+  std::vector<char> candidates = nearest->kept;
+  size_t kept = std::count(candidates.begin(), candidates.end(), true);
+  while (true) {
+    // Scanning a good part of the edges gains little over the reference scan,
+    // and that many edges as near as the nearest ones mostly means ties the
+    // check cannot clear
+    GrowSubsets attempt(tieeps_, eps_);
+    attempt.nearest_ = nearest;
+    if (4 * kept < candidates.size()) attempt.candidates_ = candidates;
+    auto subsets = attempt.buildEdgeScan(G, lambda);
+    if (attempt.candidates_.empty()) return subsets;
+
+    std::vector<int> missed = attempt.missedEdges(G);
+    if (missed.empty()) return subsets;
+    for (int k : missed) candidates[k] = true;
+    kept += missed.size();
+  }
+}
+
+void GrowSubsets::initSparse(const GraphView& G) {
+  size_t m = candidates_.size();
+  int n = G.getVertexIds().size();
+  for (size_t k = 0; k < m; k++) {
+    const EdgeRecord& e = G.getEdgeRecord(k);
+    if (e.head == e.tail) self_loops_left_.push_back(k);
+    if (candidates_[k]) edge_ids_.push_back(k);
+  }
+  ref_edges_.resize(m);
+  std::iota(ref_edges_.begin(), ref_edges_.end(), 0);
+  ref_positions_ = ref_edges_;
+  sparse_moved_.assign(m, false);
+  end_growth_.assign(2 * n, LinearFunctionPair());
+  end_growth_exact_ = true;
+}
+
+void GrowSubsets::addEndGrowth() {
+  for (const auto& s : subsets_) {
+    auto& growth = end_growth_[s->getId()];
+    if (s->getActive()) growth.first += lin_val_;
+    if (s->getTied()) {
+      growth.second += lin_val_p1_;
+      // updateEdge leaves edges without an active end alone, so their ends in
+      // a tied subset which went neutral would not get this
+      if (!s->getActive() &&
+          (lin_val_p1_.t_minus != 0 || lin_val_p1_.t_plus != 0)) {
+        end_growth_exact_ = false;
+      }
+    } else if (s->getActive()) {
+      growth.second += lin_val_p1_plus_p2_;
+    }
+  }
+}
+
+void GrowSubsets::removeSparseEdges(const std::vector<size_t>& dead,
+                                    const std::vector<int>& dropped) {
+  std::vector<int> positions;
+  for (size_t i : dead) positions.push_back(ref_positions_[edge_ids_[i]]);
+  for (int id : dropped) positions.push_back(ref_positions_[id]);
+  std::sort(positions.begin(), positions.end());
+
+  // Remove them from the reference order the way updateEdgesGivenTightEdge
+  // removes them from edge_functions_: the k-th hole below the new size is
+  // filled by the k-th remaining edge from the back
+  int size = ref_edges_.size() - positions.size();
+  int back = ref_edges_.size();
+  auto last_dead = positions.rbegin();
+  for (int hole : positions) {
+    if (hole >= size) break;
+    while (true) {
+      back--;
+      if (last_dead == positions.rend() || *last_dead != back) break;
+      ++last_dead;
+    }
+    int id = ref_edges_[back];
+    ref_edges_[hole] = id;
+    ref_positions_[id] = hole;
+    if (candidates_[id]) sparse_moved_[id] = true;
+  }
+  ref_edges_.resize(size);
+
+  // Drop dead edges from edge_functions_, keeping the rest in reference order.
+  // Edges which moved are taken out and merged back in.
+  struct MovedEdge {
+    EdgeFunctions functions;
+    std::pair<int, int> ends;
+    int id;
+  };
+  std::vector<MovedEdge> moved;
+  size_t kept = 0;
+  auto next_dead = dead.begin();
+  for (size_t i = 0; i < edge_functions_.size(); i++) {
+    if (next_dead != dead.end() && *next_dead == i) {
+      ++next_dead;
+      continue;
+    }
+    int id = edge_ids_[i];
+    if (sparse_moved_[id]) {
+      sparse_moved_[id] = false;
+      moved.push_back({std::move(edge_functions_[i]), edge_ends_[i], id});
+      continue;
+    }
+    if (kept != i) {
+      edge_functions_[kept] = std::move(edge_functions_[i]);
+      edge_ends_[kept] = edge_ends_[i];
+      edge_ids_[kept] = id;
+    }
+    kept++;
+  }
+
+  std::sort(moved.begin(), moved.end(),
+            [&](const MovedEdge& a, const MovedEdge& b) {
+              return ref_positions_[a.id] < ref_positions_[b.id];
+            });
+  size_t size_after = kept + moved.size();
+  for (size_t out = size_after; !moved.empty();) {
+    out--;
+    if (kept > 0 && ref_positions_[edge_ids_[kept - 1]] >
+                        ref_positions_[moved.back().id]) {
+      kept--;
+      edge_functions_[out] = std::move(edge_functions_[kept]);
+      edge_ends_[out] = edge_ends_[kept];
+      edge_ids_[out] = edge_ids_[kept];
+    } else {
+      edge_functions_[out] = std::move(moved.back().functions);
+      edge_ends_[out] = moved.back().ends;
+      edge_ids_[out] = moved.back().id;
+      moved.pop_back();
+    }
+  }
+  edge_functions_.resize(size_after);
+  edge_ends_.resize(size_after);
+  edge_ids_.resize(size_after);
+}
+
+// Each event changes the functions of an edge by the growth of the subsets its
+// ends are in, so once the subset c joining its ends is made they are its
+// starting values less the end growth of the subsets below c containing one
+// end. The growth is the same without the dropped edges unless one of them
+// would have gone tight first, which leaves it below zero, or would have been
+// picked as the alt edge of c instead.
+std::vector<int> GrowSubsets::missedEdges(const GraphView& G) const {
+  std::vector<int> missed;
+  size_t m = candidates_.size();
+  if (!end_growth_exact_) {
+    for (size_t k = 0; k < m; k++) {
+      if (!candidates_[k]) missed.push_back(k);
+    }
+    return missed;
+  }
+
+  // Subset each subset was merged into. Subsets are numbered in the order they
+  // were made, so the singleton of dense vertex v is v, and a subset comes
+  // after the ones merged into it.
+  int n = arena_.size();
+  std::vector<int> up(n, -1);
+  for (int id = 0; id < n; id++) {
+    const Subset* s = arena_.get(id);
+    if (s->getParent1() != nullptr) {
+      up[s->getParent1()->getId()] = id;
+      up[s->getParent2()->getId()] = id;
+    }
+  }
+
+  // End growth of each subset and the ones containing it, the size of the
+  // terms for the margin and the depth
+  std::vector<LinearFunctionPair> total(end_growth_.begin(),
+                                        end_growth_.begin() + n);
+  std::vector<double> scale(n);
+  std::vector<int> depth(n, 0);
+  for (int id = n - 1; id >= 0; id--) {
+    const auto& g = end_growth_[id];
+    scale[id] = std::fabs(g.first.t_minus) + std::fabs(g.first.t_plus) +
+                std::fabs(g.second.t_minus) + std::fabs(g.second.t_plus);
+    if (up[id] >= 0) {
+      total[id].first += total[up[id]].first;
+      total[id].second += total[up[id]].second;
+      scale[id] += scale[up[id]];
+      depth[id] = depth[up[id]] + 1;
+    }
+  }
+
+  // Smallest subset containing dense vertices a and b, or -1
+  int levels = 1;
+  while ((1 << levels) < n) levels++;
+  std::vector<std::vector<int>> jump(levels, up);
+  for (int j = 1; j < levels; j++) {
+    for (int id = 0; id < n; id++) {
+      int half = jump[j - 1][id];
+      jump[j][id] = half < 0 ? -1 : jump[j - 1][half];
+    }
+  }
+  auto join = [&](int a, int b) {
+    if (depth[a] < depth[b]) std::swap(a, b);
+    for (int j = levels - 1; j >= 0; j--) {
+      if ((depth[a] - depth[b]) >> j & 1) a = jump[j][a];
+    }
+    if (a == b) return a;
+    for (int j = levels - 1; j >= 0; j--) {
+      if (jump[j][a] != jump[j][b]) a = jump[j][a], b = jump[j][b];
+    }
+    return up[a];
+  };
+
+  // Functions of an edge of weight w between a and b once c is made, or at
+  // the end if c is -1
+  auto functions = [&](int a, int b, int c, double w) {
+    LinearFunction start{w * t_minus_, w * t_plus_};
+    LinearFunctionPair f{start - total[a].first - total[b].first,
+                         start - total[a].second - total[b].second};
+    if (c >= 0) {
+      f.first += 2 * total[c].first;
+      f.second += 2 * total[c].second;
+    }
+    return f;
+  };
+
+  for (size_t k = 0; k < m; k++) {
+    int a = nearest_->ends[k].first, b = nearest_->ends[k].second;
+    if (candidates_[k] || a == b) continue;
+    double w = G.getEdgeRecord(k).weight;
+    int c = join(a, b);
+    double margin =
+        kSparseMargin * (std::fabs(w) * t_plus_ + scale[a] + scale[b]) +
+        8 * eps_;
+    LinearFunctionPair f = functions(a, b, c, w);
+    if (f.first.t_minus <= margin) {
+      missed.push_back(k);
+      continue;
+    }
+    if (c < 0) continue;
+
+    // The edges between the parents of c get the same updates up to then, so
+    // the alt edge is compared with the values once c is made
+    const auto& alt = arena_.get(c)->getAltEdge();
+    int alt_a = vertex_index_.at(alt->getHead());
+    int alt_b = vertex_index_.at(alt->getTail());
+    LinearFunctionPair g = functions(alt_a, alt_b, c, alt->getWeight());
+    margin += kSparseMargin * (std::fabs(alt->getWeight()) * t_plus_ +
+                               scale[alt_a] + scale[alt_b]);
+    if (f.second.t_plus - g.second.t_plus <= margin) missed.push_back(k);
+  }
+  return missed;
+}
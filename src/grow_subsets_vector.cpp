@@ -0,0 +1,246 @@
+// Structure-of-arrays variant of the reference edge scan for GrowSubsets
+#include "grow_subsets.h"
+
+#include <algorithm>
+
+int GrowSubsets::addArraySubset(Subset* subset) {
+  // Subsets are added in the order arena_ numbers them
+  int id = subset->getId();
+  array_subsets_.push_back(subset);
+  subset_flags_.push_back(0);
+  refreshSubsetFlags(id);
+  return id;
+}
+
+void GrowSubsets::refreshSubsetFlags(int id) {
+  const auto& subset = array_subsets_[id];
+  subset_flags_[id] = (subset->getActive() ? kSubsetActive : 0) |
+                      (subset->getTied() ? kSubsetTied : 0);
+}
+
+EdgeFunctions GrowSubsets::arrayEdgeFunctions(int i) const {
+  return EdgeFunctions{
+      edge_arrays_.edges[i],
+      {edge_arrays_.first_minus[i], edge_arrays_.first_plus[i]},
+      {edge_arrays_.second_minus[i], edge_arrays_.second_plus[i]},
+      array_subsets_[edge_arrays_.p1[i]],
+      array_subsets_[edge_arrays_.p2[i]]};
+}
+
+// Ranges are only worth handing to the pool above this many edges each
+static const size_t kMinEdgesPerRange = 1 << 13;
+
+int GrowSubsets::edgeRanges() const {
+  if (pool_ == nullptr) return 1;
+  size_t ranges = edge_arrays_.size() / kMinEdgesPerRange;
+  if (ranges > static_cast<size_t>(pool_->size())) ranges = pool_->size();
+  return ranges > 1 ? ranges : 1;
+}
+
+template <typename F>
+void GrowSubsets::forEachEdgeRange(F f) const {
+  int ranges = edgeRanges();
+  size_t size = edge_arrays_.size();
+  auto range = [&](int r) { f(r, size * r / ranges, size * (r + 1) / ranges); };
+  if (ranges == 1) {
+    range(0);
+  } else {
+    pool_->run(ranges, range);
+  }
+}
+
+int GrowSubsets::minTiedArrayEdge(int min_e) const {
+  int s1 = edge_arrays_.p1[min_e], s2 = edge_arrays_.p2[min_e];
+  double factor = 1.0 / (int(subset_flags_[s1] & kSubsetActive) +
+                         int(subset_flags_[s2] & kSubsetActive));
+  double time_p = factor * edge_arrays_.second_plus[min_e];
+
+  // Collect the edges between the same subsets per range, then search them in
+  // order
+  std::vector<std::vector<int>> joining(edgeRanges());
+  forEachEdgeRange([&](int r, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      int a = edge_arrays_.p1[i], b = edge_arrays_.p2[i];
+      if ((a == s1 && b == s2) || (a == s2 && b == s1)) joining[r].push_back(i);
+    }
+  });
+
+  int optimizer = -1;
+  for (const auto& edges : joining) {
+    for (int i : edges) {
+      double tight_time = factor * edge_arrays_.second_plus[i];
+      if (tight_time < time_p - eps_) {
+        optimizer = i;
+        time_p = tight_time;
+      }
+    }
+  }
+  return optimizer;
+}
+
+void GrowSubsets::removeArrayEdges(
+    const std::vector<std::vector<size_t>>& removed) {
+  std::vector<size_t> dead;
+  for (const auto& edges : removed) {
+    dead.insert(dead.end(), edges.begin(), edges.end());
+  }
+  auto moves = removalMoves(edge_arrays_, dead);
+
+  size_t ranges = 1;
+  if (pool_ != nullptr) {
+    ranges = std::min<size_t>(pool_->size(), moves.size() / kMinEdgesPerRange);
+    ranges = std::max<size_t>(ranges, 1);
+  }
+  auto apply = [&](int r) {
+    for (size_t i = moves.size() * r / ranges;
+         i < moves.size() * (r + 1) / ranges; i++) {
+      edge_arrays_.move(moves[i].first, moves[i].second);
+    }
+  };
+  if (ranges == 1) {
+    apply(0);
+  } else {
+    pool_->run(ranges, apply);
+  }
+  edge_arrays_.resize(edge_arrays_.size() - dead.size());
+}
+
+std::pair<double, int> GrowSubsets::minArrayEdge() const {
+  int ranges = edgeRanges();
+  if (ranges == 1) {
+    return minEdgeArrays(edge_arrays_, eps_, 0, edge_arrays_.size());
+  }
+
+  // The serial search only changes its minimum inside ranges holding a time
+  // more than eps below it, so the others can be skipped by their minimum
+  std::vector<double> range_min(ranges);
+  forEachEdgeRange([&](int r, size_t begin, size_t end) {
+    range_min[r] = minTightTime(edge_arrays_, begin, end);
+  });
+  auto best = std::make_pair(double(INT_MAX), -1);
+  size_t size = edge_arrays_.size();
+  for (int r = 0; r < ranges; r++) {
+    if (!(range_min[r] < best.first - eps_)) continue;
+    best = minEdgeArrays(edge_arrays_, eps_, size * r / ranges,
+                         size * (r + 1) / ranges, best);
+  }
+  return best;
+}
+
+std::list<std::shared_ptr<Subset>> GrowSubsets::buildVectorScan(
+    const GraphView& G, double lambda) {
+  graph_ = &G;
+  t_minus_ = lambda * (1 - tieeps_);
+  t_plus_ = lambda * (1 + tieeps_);
+
+  std::unordered_map<int, int> vertex_ids;
+  lin_s_.resize(2 * G.getVertexIds().size());
+  for (auto v : G.getVertexIds()) {
+    int prize = G.getVertexPrize(v);
+    Subset* Sp = arena_.make(v, prize, prize);
+    subsets_.push_back(Sp);
+    double val_at_tminus = 0 * t_minus_ + 0.5 * prize;
+    double val_at_tplus = 0 * t_plus_ + 0.5 * prize;
+    lin_s_[Sp->getId()] = LinearFunctionPair{{val_at_tminus, val_at_tplus},
+                                             {val_at_tminus, val_at_tplus}};
+    vertex_ids[v] = addArraySubset(Sp);
+  }
+
+  const std::vector<int>& ids = G.getGraph().getVertexIds();
+  for (size_t k = 0; k < G.getEdgeCount(); k++) {
+    const EdgeRecord& e = G.getEdgeRecord(k);
+    LinearFunction weight{e.weight * t_minus_ + 0., e.weight * t_plus_ + 0.};
+    edge_arrays_.push_back(k, weight, weight, vertex_ids.at(ids[e.head]),
+                           vertex_ids.at(ids[e.tail]));
+  }
+
+  forEachEdgeRange([&](int, size_t begin, size_t end) {
+    updateEdgeArrays(DualGrowth(), subset_flags_.data(), SubsetChange(), begin,
+                     end, &edge_arrays_);
+  });
+  auto min_edge = minArrayEdge();
+  auto time_e = min_edge.first;
+  int min_e = min_edge.second;
+
+  while (true) {
+    auto min_set = minSetTime();
+    auto time_s = min_set.first;
+    auto min_s = min_set.second;
+
+    if ((min_s == nullptr) && (min_e < 0)) return shareRoots();
+
+    EdgeFunctions min_e_functions;
+    lin_val_ = LinearFunction{0, 0};
+    if (min_s == nullptr || time_e < time_s + eps_) {
+      min_s = nullptr;
+      min_e_functions = arrayEdgeFunctions(min_e);
+      double factor = 1.0 / (int(min_e_functions.p1->getActive()) +
+                             int(min_e_functions.p2->getActive()));
+      lin_val_ = {factor * min_e_functions.first.t_minus,
+                  factor * min_e_functions.first.t_plus};
+    } else {
+      lin_val_ = lin_s_[min_s->getId()].first;
+    }
+    alt_e_ = min_e_functions.edge;
+
+    lin_val_p1_ = LinearFunction{0., 0.};
+    lin_val_p2_ = LinearFunction{lin_val_.t_minus, lin_val_.t_plus};
+    if (min_e_functions.edge >= 0) {
+      int alt_e = minTiedArrayEdge(min_e);
+      EdgeFunctions alt_e_functions;
+      if (alt_e >= 0) alt_e_functions = arrayEdgeFunctions(alt_e);
+      resolveTies(min_e_functions, alt_e >= 0 ? &alt_e_functions : nullptr,
+                  lin_s_[min_e_functions.p1->getId()].second,
+                  lin_s_[min_e_functions.p2->getId()].second);
+      refreshSubsetFlags(edge_arrays_.p1[min_e]);
+      refreshSubsetFlags(edge_arrays_.p2[min_e]);
+    }
+
+    lin_val_p1_plus_p2_ =
+        LinearFunction{lin_val_p1_.t_minus + lin_val_p2_.t_minus,
+                       lin_val_p1_.t_plus + lin_val_p2_.t_plus};
+    updateSubsets();
+
+    SubsetChange change;
+    if (min_s != nullptr) {
+      change.neutral = min_s->getId();
+    } else {
+      auto S1 = min_e_functions.p1;
+      auto S2 = min_e_functions.p2;
+      auto S = mergeSubsets(S1, S2, min_e_functions.edge);
+      const auto& f1 = lin_s_[S1->getId()];
+      const auto& f2 = lin_s_[S2->getId()];
+      lin_s_[S->getId()] = LinearFunctionPair{
+          {f1.first.t_minus + f2.first.t_minus,
+           f1.first.t_plus + f2.first.t_plus},
+          {f1.second.t_minus + f2.second.t_minus,
+           f1.second.t_plus + f2.second.t_plus}};
+
+      subsets_.remove(S1);
+      subsets_.remove(S2);
+      subsets_.push_back(S);
+
+      change.s1 = edge_arrays_.p1[min_e];
+      change.s2 = edge_arrays_.p2[min_e];
+      change.merged = addArraySubset(S);
+    }
+
+    DualGrowth growth{lin_val_, lin_val_p1_, lin_val_p1_plus_p2_};
+    std::vector<std::vector<size_t>> removed(edgeRanges());
+    forEachEdgeRange([&](int r, size_t begin, size_t end) {
+      updateEdgeArrays(growth, subset_flags_.data(), change, begin, end,
+                       &edge_arrays_,
+                       change.merged >= 0 ? &removed[r] : nullptr);
+    });
+    if (change.merged >= 0) removeArrayEdges(removed);
+
+    min_edge = minArrayEdge();
+    time_e = min_edge.first;
+    min_e = min_edge.second;
+
+    if (min_s != nullptr) {
+      min_s->setActive(false);
+      refreshSubsetFlags(change.neutral);
+    }
+  }
+}
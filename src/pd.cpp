@@ -14,11 +14,21 @@ double ep = 1.0e-15;  // theshold for ties
 
 /* ------------------------- HELPER FUNCTIONS--------------------------*/
 
-void solveInstance(SolverInfo &info) {
+void solveInstance(SolverInfo &info, SubproblemCache *cache) {
   auto t0 = std::chrono::high_resolution_clock::now();
+  SubproblemCache own_cache;
+  if (cache == nullptr) cache = &own_cache;
+  int hits = cache->hits(), misses = cache->misses();
   PD(info.problem.graph, info.problem.budget, info.solution.path,
      info.solution.upper_bound, info.recursions, info.lambda,
-     info.solution.solved, true, info.problem.time_limit);
+     info.solution.solved, true, info.problem.time_limit,
+     info.problem.options,
+     info.problem.options.cache_subproblems ? cache : nullptr);
+  info.cache_hits = cache->hits() - hits;
+  info.cache_misses = cache->misses() - misses;
+  if (info.problem.options.improve_tour) {
+    buildTour(info.problem, info.solution);
+  }
   auto t1 = std::chrono::high_resolution_clock::now();
   info.solution.prize = prizeTree(info.problem.graph, info.solution.path);
   info.walltime =
@@ -30,38 +40,43 @@ void solveInstance(SolverInfo &info) {
 
 // Change all edges to alt edges
 void reverseEdges(std::shared_ptr<Subset> &s) {
-  // Base case is that s does not have a parent
-  if (s->getParent1() == NULL) {
-    return;
-  }
+  std::vector<Subset *> stack = {s.get()};
+  while (!stack.empty()) {
+    Subset *t = stack.back();
+    stack.pop_back();
+
+    // Base case is that t does not have a parent
+    if (t->getParent1() == NULL) {
+      continue;
+    }
 
-  // Otherwise check if alternative edge is different from min edge
-  if ((s->getAltEdge() != NULL) && (s->getAltEdge() != s->getEdge())) {
-    s->swapEdges();
-  }
+    // Otherwise check if alternative edge is different from min edge
+    if ((t->getAltEdge() != NULL) && (t->getAltEdge() != t->getEdge())) {
+      t->swapEdges();
+    }
 
-  // Recurse on parents
-  std::shared_ptr<Subset> p1 = s->getParent1(), p2 = s->getParent2();
-  reverseEdges(p1);
-  reverseEdges(p2);
+    // Go on to parents
+    stack.push_back(t->getParent2());
+    stack.push_back(t->getParent1());
+  }
 }
 
 // Calculate prize of all vertices in tree
-int prizeTree(const Graph &G, std::list<std::shared_ptr<Edge>> &tree) {
+int prizeTree(const GraphView &G, std::list<std::shared_ptr<Edge>> &tree) {
   int p = 0;
   std::unordered_map<int, bool> added;
-  for (auto v : G.getVertices()) {
+  for (auto v : G.getVertexIds()) {
     added[v] = false;
   }
 
   for (auto e : tree) {
     int i = e->getHead(), j = e->getTail();
     if (added[i] == false) {
-      p += G.getVertex(i)->getPrize();
+      p += G.getVertexPrize(i);
       added[i] = true;
     }
     if (added[j] == false) {
-      p += G.getVertex(j)->getPrize();
+      p += G.getVertexPrize(j);
       added[j] = true;
     }
   }
@@ -70,15 +85,17 @@ int prizeTree(const Graph &G, std::list<std::shared_ptr<Edge>> &tree) {
 }
 
 // Finds initial l and r values such that PD(l+) > 0.5 D and PD(r-) <= 0.5 D
-void findLR(const Graph &G, double D, double &l, double &r) {
+void findLR(const GraphView &G, double D, double &l, double &r,
+            const SolverOptions &options) {
   // Find min and max non-zero edge weights
   double min_w = INT_MAX, max_w = -INT_MAX;
-  for (auto e : G.getEdges()) {
-    if ((e->getWeight() > ep) && (e->getWeight() < min_w)) {
-      min_w = e->getWeight();
+  for (size_t k = 0; k < G.getEdgeCount(); k++) {
+    double w = G.getEdgeRecord(k).weight;
+    if ((w > ep) && (w < min_w)) {
+      min_w = w;
     }
-    if (e->getWeight() > max_w) {
-      max_w = e->getWeight();
+    if (w > max_w) {
+      max_w = w;
     }
   }
 
@@ -87,7 +104,7 @@ void findLR(const Graph &G, double D, double &l, double &r) {
   r = G.getPrize() / (min_w) + 1;
 
   // Check that l and r satisfy properties
-  GrowSubsets g;
+  GrowSubsets g(options);
   std::list<std::shared_ptr<Subset>> subsetsL = g.build(G, l);
   double weight_l = reverseDelete(subsetsL, true);
   if (weight_l <= 0.5 * D) {
@@ -95,7 +112,7 @@ void findLR(const Graph &G, double D, double &l, double &r) {
     throw std::invalid_argument("Left point not satisfied");
   }
 
-  GrowSubsets g2;
+  GrowSubsets g2(options);
   std::list<std::shared_ptr<Subset>> subsetsR = g2.build(G, r);
   double weight_r = reverseDelete(subsetsR, false);
   if (weight_r >= 0.5 * D) {
@@ -109,46 +126,103 @@ void findLR(const Graph &G, double D, double &l, double &r) {
 void findTies(const std::shared_ptr<Subset> &s,
               std::list<std::shared_ptr<Subset>> &tiedEdges,
               std::list<std::shared_ptr<Subset>> &tiedSubsets, bool swap) {
-  // If tied then push back
-  if (s->getTied() && s->getActive()) {
-    tiedSubsets.push_back(s);
-  }
+  std::vector<Subset *> stack = {s.get()};
+  while (!stack.empty()) {
+    Subset *t = stack.back();
+    stack.pop_back();
+
+    // If tied then push back, sharing the family of s
+    if (t->getTied() && t->getActive()) {
+      tiedSubsets.push_back(std::shared_ptr<Subset>(s, t));
+    }
 
-  // Base case is that s does not have a parent
-  if (s->getParent1() == NULL) {
-    return;
-  }
+    // Base case is that t does not have a parent
+    if (t->getParent1() == NULL) {
+      continue;
+    }
 
-  // Otherwise check if alternative edge is different from min edge
-  if ((s->getAltEdge() != NULL) && (s->getAltEdge() != s->getEdge()) &&
-      (swap)) {
-    tiedEdges.push_back(s);
-  }
+    // Otherwise check if alternative edge is different from min edge
+    if ((t->getAltEdge() != NULL) && (t->getAltEdge() != t->getEdge()) &&
+        (swap)) {
+      tiedEdges.push_back(std::shared_ptr<Subset>(s, t));
+    }
 
-  // Recurse on parents
-  findTies(s->getParent1(), tiedEdges, tiedSubsets, swap);
-  findTies(s->getParent2(), tiedEdges, tiedSubsets, swap);
+    // Go on to parents
+    stack.push_back(t->getParent2());
+    stack.push_back(t->getParent1());
+  }
 }
 
 /* ------------------------- MAIN FUNCTIONS--------------------------*/
 
-double findLambdaBin(const Graph &G, double D) {
+double findLambdaBin(const GraphView &G, double D) {
   bool found, swap, reversed;
   return findLambdaBin(G, D, found, swap, reversed, static_cast<double>(INT_MAX));
 }
 
+// Result of running PD at one lambda of findLambdaBin
+enum class LambdaProbe {
+  kFound,     // PD(lambda-) > 0.5*D and PD(lambda+) <= 0.5*D
+  kNoSwap,    // the same, but only without swapping in the alt edges
+  kReversed,  // PD(lambda-) <= 0.5*D and PD(lambda+) > 0.5*D
+  kBelow,     // lambda is too large
+  kAbove,     // lambda is too small
+};
+
+static LambdaProbe probeLambda(const GraphView &G, double D, double p,
+                               const SolverOptions &options, GrowthLog *log,
+                               double lo, double hi) {
+  GrowSubsets g(options);
+  std::list<std::shared_ptr<Subset>> subsets =
+      log != nullptr ? g.build(G, p, log, lo, hi) : g.build(G, p);
+  ReverseDeleteWeights weights = reverseDeleteAll(subsets);
+  double wminus = weights.minus, wplus = weights.plus;
+  double wplusalt = weights.plus_noswap;  // don't swap edges
+  // std::cout << wminus << "," << wplus << "," << wplusalt << "\n";
+  if ((wminus > 0.5 * D) && (wplus <= 0.5 * D)) {
+    return LambdaProbe::kFound;
+  } else if ((wminus > 0.5 * D) && (wplusalt <= 0.5 * D)) {
+    return LambdaProbe::kNoSwap;
+  } else if ((wminus <= 0.5 * D) && (wplus > 0.5 * D)) {
+    return LambdaProbe::kReversed;
+  } else if (wminus <= 0.5 * D) {
+    return LambdaProbe::kBelow;
+  }
+  return LambdaProbe::kAbove;
+}
+
 // Use binary search to find theshold value lambda such that PD(lambda-) > 0.5*D
 // and PD(lambda+) <= 0.5D
-double findLambdaBin(const Graph &G, double D, bool &found, bool &swap,
-                     bool &reversed, double max_solve_time) {
+double findLambdaBin(const GraphView &G, double D, bool &found, bool &swap,
+                     bool &reversed, double max_solve_time,
+                     const SolverOptions &options) {
   auto t0 = std::chrono::high_resolution_clock::now();
   // Find initial l and r
   double l, r;
-  findLR(G, D, l, r);
+  findLR(G, D, l, r, options);
   int iters = 0;
   double diff = ep;
   swap = true, reversed = false;
 
+  // Each round probes the next depth levels of the bisection at once, in
+  // heap order over the tree of intervals, and then walks down the tree.
+  // The probes run on their own threads, so their builds do not use the pool
+  // as well.
+  int depth = 1;
+  while ((2 << depth) - 1 <= options.lambda_probes) depth++;
+  int n = (1 << depth) - 1;
+  SolverOptions probe_options = options;
+  if (n > 1) probe_options.num_threads = 1;
+  std::vector<double> lo(n), hi(n), p(n);
+  std::vector<LambdaProbe> probes(n);
+
+  // Event logs of the probes at l and r, and of the probes of a round, each
+  // seeded with whichever of the two replays more events
+  bool use_logs =
+      options.warm_start_probes || options.parametric_lambda_search;
+  GrowthLog log_l, log_r;
+  std::vector<GrowthLog> logs(use_logs ? n : 0);
+
   // Do binary search
   while (l * (1 + diff) <= r) {
     auto t1 = std::chrono::high_resolution_clock::now();
@@ -158,31 +232,65 @@ double findLambdaBin(const Graph &G, double D, bool &found, bool &swap,
       found = false;
       return -1;
     }
-    double p = (l + r) / 2;
-    // std::cout << "iters: " << iters << " l: " << l << " r: " << r << " p: "
-    // << p << "\n";
-    iters += 1;
-    GrowSubsets g;
-    std::list<std::shared_ptr<Subset>> subsets = g.build(G, p);
-    double wminus = reverseDelete(subsets, false),
-           wplus = reverseDelete(subsets, true, true);
-    double wplusalt = reverseDelete(subsets, true, false);  // don't swap edges
-    // std::cout << wminus << "," << wplus << "," << wplusalt << "\n";
-    if ((wminus > 0.5 * D) && (wplus <= 0.5 * D)) {
-      found = true;
-      return p;
-    } else if ((wminus > 0.5 * D) && (wplusalt <= 0.5 * D)) {
-      swap = false;
-      found = true;
-      return p;
-    } else if ((wminus <= 0.5 * D) && (wplus > 0.5 * D)) {
-      reversed = true;
-      found = true;
-      return p;
-    } else if (wminus <= 0.5 * D) {
-      r = p;
-    } else {
-      l = p;
+    lo[0] = l;
+    hi[0] = r;
+    for (int i = 0; i < n; i++) {
+      p[i] = (lo[i] + hi[i]) / 2;
+      if (2 * i + 2 < n) {
+        lo[2 * i + 1] = lo[i];
+        hi[2 * i + 1] = p[i];
+        lo[2 * i + 2] = p[i];
+        hi[2 * i + 2] = hi[i];
+      }
+    }
+    ThreadPool::shared(n).run(n, [&](int i) {
+      // Intervals the bisection would stop at are never reached
+      if (lo[i] * (1 + diff) > hi[i]) return;
+      // The same family as at l or r gives the same result
+      if (options.parametric_lambda_search && log_l.covers(p[i])) {
+        logs[i] = log_l;
+        probes[i] = LambdaProbe::kAbove;
+        return;
+      }
+      if (options.parametric_lambda_search && log_r.covers(p[i])) {
+        logs[i] = log_r;
+        probes[i] = LambdaProbe::kBelow;
+        return;
+      }
+      GrowthLog *log = nullptr;
+      if (use_logs) {
+        log = &logs[i];
+        *log = log_l.prefix(p[i]) >= log_r.prefix(p[i]) ? log_l : log_r;
+      }
+      probes[i] = probeLambda(G, D, p[i], probe_options, log, lo[i], hi[i]);
+    });
+
+    for (int i = 0; i < n && l * (1 + diff) <= r;) {
+      // std::cout << "iters: " << iters << " p: " << p[i] << "\n";
+      iters += 1;
+      switch (probes[i]) {
+        case LambdaProbe::kFound:
+          found = true;
+          return p[i];
+        case LambdaProbe::kNoSwap:
+          swap = false;
+          found = true;
+          return p[i];
+        case LambdaProbe::kReversed:
+          reversed = true;
+          found = true;
+          return p[i];
+        case LambdaProbe::kBelow:
+          r = p[i];
+          if (use_logs) log_r = std::move(logs[i]);
+          i = 2 * i + 1;
+          break;
+        case LambdaProbe::kAbove:
+          l = p[i];
+          if (use_logs) log_l = std::move(logs[i]);
+          i = 2 * i + 2;
+          break;
+      }
     }
   }
 
@@ -205,14 +313,14 @@ std::shared_ptr<Edge> findTree(std::shared_ptr<Subset> &s, double D,
   std::vector<std::shared_ptr<Subset>> subsetsPruned;
   std::vector<std::shared_ptr<Edge>> edgesPruned;
 
-  // First go through tiedEdges and change to alternate edges
+  // First go through tiedEdges and change to alternate edges. The weight of
+  // reverseDelete(s) is kept up to date after each change
+  IncrementalPrune pruned(s);
   bool broke = false;
   for (auto test : tiedEdges) {
     // std::cout << "Test " << *test << "\n";
     // See if change brings above threshold
-    std::shared_ptr<Edge> e = test->getEdge(), alt_e = test->getAltEdge();
-    test->swapEdges();
-    if (reverseDelete(s) <= 0.5 * D) {
+    if (pruned.swapEdges(test) <= 0.5 * D) {
       std::list<std::shared_ptr<Edge>> temp_e;
       maxPrunedE(s, temp_e, test, subsetsPruned, edgesPruned);
       broke = true;
@@ -225,8 +333,7 @@ std::shared_ptr<Edge> findTree(std::shared_ptr<Subset> &s, double D,
     for (auto test : tiedSubsets) {
       // std::cout << "Test " << *test;
       // See if change brings above threshold
-      test->setActive(false);
-      if (reverseDelete(s) <= 0.5 * D) {
+      if (pruned.setInactive(test) <= 0.5 * D) {
         // std::cout << "Broke here \n";
         std::list<std::shared_ptr<Edge>> temp_e;
         maxPrunedS(s, temp_e, test, subsetsPruned, edgesPruned);
@@ -291,20 +398,127 @@ std::shared_ptr<Edge> findTree(std::shared_ptr<Subset> &s, double D,
   return break_e;
 }
 
+// PD on the subgraph of G on the vertices of s, or its result from cache,
+// writing its progress to out
+static SubproblemResult solveSubproblem(const GraphView &G, double D,
+                                        const std::shared_ptr<Subset> &s,
+                                        double max_solve_time,
+                                        const SolverOptions &options,
+                                        SubproblemCache *cache,
+                                        std::ostream &out) {
+  SubproblemResult result;
+  std::vector<int> vertices;
+  if (cache != nullptr) {
+    vertices.assign(s->getVertices().begin(), s->getVertices().end());
+    if (cache->find(vertices, D, &result)) return result;
+  }
+
+  GraphView H(G, s->getVertices());  // Find subgraph
+  bool found;
+  PD(H, D, result.edges, result.upper, result.recursions, result.lambda, found,
+     true, max_solve_time, options, cache, &result.complete, out);  // Recurse
+  result.prize = prizeTree(G, result.edges);
+
+  // A result with a search cut short by the time limit anywhere in it is not
+  // kept, as it may be worse than one with more time
+  if (cache != nullptr && result.complete) cache->insert(vertices, D, result);
+  return result;
+}
+
+// Result of PD on the subgraph of one high potential subset
+struct Subproblem {
+  bool solved = false;
+  SubproblemResult result;
+  std::exception_ptr error;
+  std::string output;  // progress PD wrote while solving it
+};
+
+// The recursion at the end of PD with the subproblems solved at once on
+// options.recursion_threads threads. The subproblems are then taken in order as
+// the sequential loop does, so tree, currPrize and recursions come out the
+// same. A subproblem is only skipped when one before it already found a tree
+// with at least its prize, as the sequential loop would skip it then too. The
+// progress of each subproblem is kept and written to out in that order, for
+// the subproblems the sequential loop solves, so it comes out the same too.
+static void recurseInParallel(const GraphView &G, double D,
+                              const std::list<std::shared_ptr<Subset>> &altS,
+                              std::list<std::shared_ptr<Edge>> &tree,
+                              int &currPrize, int &recursions,
+                              bool &complete, double max_solve_time,
+                              const SolverOptions &options,
+                              SubproblemCache *cache, std::ostream &out) {
+  std::vector<std::shared_ptr<Subset>> tests(altS.begin(), altS.end());
+  std::vector<Subproblem> results(tests.size());
+  std::mutex mutex;
+
+  // Subproblems run on their own threads, so they do not use pools as well
+  SolverOptions sub_options = options;
+  sub_options.num_threads = 1;
+  sub_options.lambda_probes = 1;
+  sub_options.recursion_threads = 1;
+
+  ThreadPool::shared(options.recursion_threads).run(tests.size(), [&](int i) {
+    int prize = tests[i]->getPrize();
+    if (prize <= currPrize) return;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (int k = 0; k < i; k++) {
+        if (results[k].solved && results[k].result.prize >= prize) return;
+      }
+    }
+
+    Subproblem subproblem;
+    std::ostringstream progress;
+    try {
+      subproblem.result = solveSubproblem(G, D, tests[i], max_solve_time,
+                                          sub_options, cache, progress);
+    } catch (...) {
+      subproblem.error = std::current_exception();
+    }
+    subproblem.solved = true;
+    subproblem.output = progress.str();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    results[i] = std::move(subproblem);
+  });
+
+  for (size_t i = 0; i < tests.size(); i++) {
+    if (tests[i]->getPrize() > currPrize) {
+      if (!results[i].solved) {
+        throw std::logic_error("Skipped a subproblem the recursion needs");
+      }
+      out << results[i].output;
+      if (results[i].error) std::rethrow_exception(results[i].error);
+      const SubproblemResult &result = results[i].result;
+      recursions += result.recursions;
+      complete = complete && result.complete;
+
+      // If better than current tree then replace
+      if (result.prize > currPrize) {
+        tree = result.edges;
+        currPrize = result.prize;
+      }
+    }
+  }
+}
+
 // Main function
-int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
+int PD(const GraphView &G, double D, std::list<std::shared_ptr<Edge>> &edges,
        double &upper, int &recursions, double &lambda, bool &found,
-       bool recurse, double max_solve_time) {
+       bool recurse, double max_solve_time, const SolverOptions &options,
+       SubproblemCache *cache, bool *complete, std::ostream &out) {
   auto t0 = std::chrono::high_resolution_clock::now();
   recursions = 1;
+  bool all_found = true;
+  if (complete != nullptr) *complete = true;
 
-  std::cout << " -------- Starting Alg ----------- \n";
+  out << " -------- Starting Alg ----------- \n";
   // std::cout << " GRAPH: " << G;
 
   // If a MST is feasible, return
   std::list<std::shared_ptr<Edge>> mst;
   double mst_w = G.MST(mst);
-  std::cout << "- MST weight: " << mst_w << "\n";
+  out << "- MST weight: " << mst_w << "\n";
   if (mst_w <= 0.5 * D) {
     // std::cout << "Returning MST of weight " << mst_w << "\n";
     edges = mst;
@@ -312,22 +526,25 @@ int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
     return G.getPrize();
   }
 
-  std::cout << "- Total Prize " << G.getPrize() << "\n";
+  out << "- Total Prize " << G.getPrize() << "\n";
 
-  std::cout << " --------------------------------- \n";
+  out << " --------------------------------- \n";
   // Otherwise find threshold lambda
   bool swap = true, reversed = false;
-  lambda = findLambdaBin(G, D, found, swap, reversed, max_solve_time);
+  lambda =
+      findLambdaBin(G, D, found, swap, reversed, max_solve_time, options);
   if (!found) {
     upper = 0.0;
     edges.clear();
+    // Only a search the time limit cut short returns a negative lambda
+    if (complete != nullptr && lambda < 0) *complete = false;
     return 0;
   }
-  std::cout << "- Lambda1: " << lambda << "\n";
+  out << "- Lambda1: " << lambda << "\n";
   // std::cout << "- Found: " << found << "\n";
 
   // Then find largest subsets
-  GrowSubsets g;
+  GrowSubsets g(options);
   std::list<std::shared_ptr<Subset>> subsets = g.build(G, lambda);
   // If reversed (wplus > 0.5*D) then we need to start with reversed edges
   if (reversed) {
@@ -343,14 +560,14 @@ int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
   std::list<std::shared_ptr<Edge>> tree;
   std::shared_ptr<Edge> last_e = findTree(s, D, tree, swap);
   int currPrize = prizeTree(G, tree);
-  std::cout << "- Prize of tree found: " << currPrize << "\n";
+  out << "- Prize of tree found: " << currPrize << "\n";
 
   // Compute weight
   double wTree = 0;
   for (auto e : tree) {
     wTree += e->getWeight();
   }
-  std::cout << "- Weight of tree: " << wTree << "\n";
+  out << "- Weight of tree: " << wTree << "\n";
   // if (last_e != NULL)
   //    std::cout << "- Weight of last edge: " << last_e->getWeight() << "\n";
 
@@ -360,7 +577,7 @@ int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
   if (upper > G.getPrize()) {
     upper = G.getPrize();
   }
-  std::cout << "- Upper bound: " << upper << "\n";
+  out << "- Upper bound: " << upper << "\n";
 
   // Find set with highest potential that contains tree
   double p = max_s->getPotential() - 0.0001;
@@ -383,24 +600,23 @@ int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
   // Recurse on subgraphs with high potential and return best found
   if (recurse) {
     std::list<std::shared_ptr<Subset>> altS = findHighPotential(subsets, p);
-    std::cout << "-------- Recursing " << altS.size() << " times -------- \n";
-    for (auto test_s : altS) {
-      if (test_s->getPrize() > currPrize) {
-        Graph H(G, test_s->getVertices());  // Find subgraph
-        double test_upper;
-        int test_recursions;
-        double test_lambda;
-        bool test_found;
-        std::list<std::shared_ptr<Edge>> test_e;
-        PD(H, D, test_e, test_upper, test_recursions, test_lambda, test_found,
-           recurse, max_solve_time);  // Recurse
-        recursions += test_recursions;
-
-        // If better than current tree then replace
-        int test_p = prizeTree(G, test_e);
-        if (test_p > currPrize) {
-          tree = test_e;
-          currPrize = test_p;
+    out << "-------- Recursing " << altS.size() << " times -------- \n";
+    if (options.recursion_threads > 1) {
+      recurseInParallel(G, D, altS, tree, currPrize, recursions, all_found,
+                        max_solve_time, options, cache, out);
+    } else {
+      for (auto test_s : altS) {
+        if (test_s->getPrize() > currPrize) {
+          SubproblemResult result = solveSubproblem(
+              G, D, test_s, max_solve_time, options, cache, out);  // Recurse
+          recursions += result.recursions;
+          all_found = all_found && result.complete;
+
+          // If better than current tree then replace
+          if (result.prize > currPrize) {
+            tree = result.edges;
+            currPrize = result.prize;
+          }
         }
       }
     }
@@ -409,6 +625,7 @@ int PD(const Graph &G, double D, std::list<std::shared_ptr<Edge>> &edges,
   // std::cout << "---------- Done Recursing -------------- \n";
   // std::cout << "- New best: " << currPrize << "\n";
   edges = tree;
+  if (complete != nullptr) *complete = all_found;
 
   return currPrize;
 }
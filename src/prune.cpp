@@ -10,140 +10,412 @@
 
 #include "prune.h"
 
-// Prune Function
-double prune(std::shared_ptr<Subset>& s,
-             std::list<std::shared_ptr<Edge>>& edges, bool l_plus, bool swap) {
-  // Base case is that s does not have a parent
-  if (s->getParent1() == nullptr) {
-    return 0;
-  }
-
-  // Otherwise find parents and number of endpoints
-  std::shared_ptr<Subset> p1 = s->getParent1(), p2 = s->getParent2();
-  std::shared_ptr<Edge> e = s->getEdge(), alt_e = s->getAltEdge();
-  if ((l_plus == true) && (alt_e != nullptr) && (swap == true)) {
-    e = alt_e;
-  }
-
-  // Find degree of p1 given current edges
-  int connected1 = 0;
-  for (auto v : p1->getVertices()) {
-    for (auto e : edges) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connected1 += 1;
-    }
-  }
-
-  // Find degree of p2 given current edges
-  int connected2 = 0;
-  for (auto v : p2->getVertices()) {
-    for (auto e : edges) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connected2 += 1;
-    }
-  }
-
-  // Find if active. If l_plus = true don't include those that tied
-  bool p1active = p1->getActive();
-  bool p2active = p2->getActive();
-  if (l_plus) {
-    if (p1->getTied()) {
-      p1active = false;
-    }
-    if (p2->getTied()) {
-      p2active = false;
-    }
+#include "incidence_counts.h"
+
+// What prune does at a subset with parents p1 and p2
+enum class PruneStep {
+  kBoth,     // keep the edge between them and recurse on both
+  kParent1,  // prune p2 and recurse on p1
+  kParent2,  // prune p1 and recurse on p2
+  kLargest,  // no edges yet, keep the larger of the two
+  kNone,     // prune both
+};
+
+// Last edge of edges with an end in p
+static std::shared_ptr<Edge> lastIncident(
+    const IncidenceCounts& counts, const Subset* p,
+    const std::list<std::shared_ptr<Edge>>& edges) {
+  std::shared_ptr<Edge> incident = nullptr;
+  for (const auto& e : edges) {
+    if (counts.ends(p, e) > 0) incident = e;
   }
+  return incident;
+}
 
+// Step of prune given if the parents are active and their degrees
+static PruneStep pruneStep(bool p1active, bool p2active, int connected1,
+                           int connected2, bool no_edges) {
   // If p1 and p2 are active or neither needs to be pruned, add edge between and
   // recurse
   if (((p1active && p2active) || (p1active && connected2)) ||
       (p2active && connected1) || ((connected1 > 0) && (connected2 > 0))) {
-    edges.push_back(e);
-    double w1 = prune(p1, edges, l_plus, swap);
-    double w2 = prune(p2, edges, l_plus, swap);
-    return w1 + w2 + e->getWeight();
+    return PruneStep::kBoth;
   }
 
   // Else if p1 is active or does need to be pruned, recurse on p1
   else if ((p1active) || (connected1 > 1)) {
-    // std::cout << "Prune " << *p2;
-    return prune(p1, edges, l_plus, swap);
+    return PruneStep::kParent1;
   }
 
   // Else if p2 is active or does need to be pruned, recurse on p2
   else if ((p2active) || (connected2 > 1)) {
-    // std::cout << "Prune " << *p1;
-    return prune(p2, edges, l_plus, swap);
+    return PruneStep::kParent2;
   }
 
   // Else if no edges are added yet - find largest and return
-  else if (edges.size() == 0) {
-    std::list<std::shared_ptr<Edge>> edges1, edges2;
-    double w1 = prune(p1, edges1, l_plus, swap),
-           w2 = prune(p2, edges2, l_plus, swap);
-    if (w1 > w2) {
-      edges = edges1;
-      return w1;
-    } else {
-      edges = edges2;
-      return w2;
-    }
+  else if (no_edges) {
+    return PruneStep::kLargest;
   }
 
-  return 0;
+  return PruneStep::kNone;
 }
 
-// Find path of maximal pruned subsets that are not pruned when s is marked
-// active
-void maxPrunedS(std::shared_ptr<Subset>& s,
-                std::list<std::shared_ptr<Edge>>& edges,
-                std::shared_ptr<Subset>& tied_S,
-                std::vector<std::shared_ptr<Subset>>& prunedS,
-                std::vector<std::shared_ptr<Edge>>& prunedE) {
+using EdgeList = std::list<std::shared_ptr<Edge>>;
+
+// Subsets still to walk, the next one at the back. Parents are pushed in
+// reverse, so the walk goes in the order of the recursive definitions.
+using SubsetStack = std::vector<Subset*>;
+
+// One step of the walk of prune: a subset to prune into edges, or (s ==
+// nullptr) the weights of both parents of a kBoth or kLargest step to combine
+struct PruneTask {
+  Subset* s;
+  EdgeList* edges;
+  PruneStep step;
+  std::shared_ptr<Edge> e;     // edge kept by kBoth
+  EdgeList* edges1 = nullptr;  // lists of the parents of kLargest
+  EdgeList* edges2 = nullptr;
+};
+
+// Prune Function. The laminar family is walked with an explicit stack, in the
+// order of the recursive definition, with counts holding the ends of the kept
+// edges. Subsets whose branch is dropped by kLargest may leave their edges in
+// counts, nothing outside them is counted again.
+double prune(std::shared_ptr<Subset>& s,
+             std::list<std::shared_ptr<Edge>>& edges, bool l_plus, bool swap) {
+  IncidenceCounts counts(s.get(), edges);
+  std::list<EdgeList> largest_lists;  // owns the lists made by kLargest
+  std::vector<PruneTask> tasks;
+  std::vector<double> weights;
+  tasks.push_back(PruneTask{s.get(), &edges, PruneStep::kNone, nullptr});
+  while (!tasks.empty()) {
+    PruneTask task = std::move(tasks.back());
+    tasks.pop_back();
+
+    // Combine the weights of both parents
+    if (task.s == nullptr) {
+      double w2 = weights.back();
+      weights.pop_back();
+      double& w1 = weights.back();
+      if (task.step == PruneStep::kBoth) {
+        w1 = w1 + w2 + task.e->getWeight();
+      } else if (w1 > w2) {
+        *task.edges = std::move(*task.edges1);
+      } else {
+        *task.edges = std::move(*task.edges2);
+        w1 = w2;
+      }
+      continue;
+    }
+
+    // Base case is that s does not have a parent
+    const Subset* t = task.s;
+    if (t->getParent1() == nullptr) {
+      weights.push_back(0);
+      continue;
+    }
+
+    // Otherwise find parents and number of endpoints
+    Subset *p1 = t->getParent1(), *p2 = t->getParent2();
+    std::shared_ptr<Edge> e = t->getEdge(), alt_e = t->getAltEdge();
+    if ((l_plus == true) && (alt_e != nullptr) && (swap == true)) {
+      e = alt_e;
+    }
+
+    // Find degree of p1 and p2 given current edges
+    int connected1 = counts.count(p1);
+    int connected2 = counts.count(p2);
+
+    // Find if active. If l_plus = true don't include those that tied
+    bool p1active = p1->getActive();
+    bool p2active = p2->getActive();
+    if (l_plus) {
+      if (p1->getTied()) {
+        p1active = false;
+      }
+      if (p2->getTied()) {
+        p2active = false;
+      }
+    }
+
+    // Tasks go on the stack in reverse, so p1 is pruned before p2
+    switch (pruneStep(p1active, p2active, connected1, connected2,
+                      task.edges->size() == 0)) {
+      case PruneStep::kBoth:
+        task.edges->push_back(e);
+        counts.add(e);
+        tasks.push_back(
+            PruneTask{nullptr, task.edges, PruneStep::kBoth, std::move(e)});
+        tasks.push_back(PruneTask{p2, task.edges, PruneStep::kNone, nullptr});
+        tasks.push_back(PruneTask{p1, task.edges, PruneStep::kNone, nullptr});
+        break;
+      case PruneStep::kParent1:
+        tasks.push_back(PruneTask{p1, task.edges, PruneStep::kNone, nullptr});
+        break;
+      case PruneStep::kParent2:
+        tasks.push_back(PruneTask{p2, task.edges, PruneStep::kNone, nullptr});
+        break;
+      case PruneStep::kLargest: {
+        largest_lists.emplace_back();
+        EdgeList* edges1 = &largest_lists.back();
+        largest_lists.emplace_back();
+        EdgeList* edges2 = &largest_lists.back();
+        tasks.push_back(PruneTask{nullptr, task.edges, PruneStep::kLargest,
+                                  nullptr, edges1, edges2});
+        tasks.push_back(PruneTask{p2, edges2, PruneStep::kNone, nullptr});
+        tasks.push_back(PruneTask{p1, edges1, PruneStep::kNone, nullptr});
+        break;
+      }
+      case PruneStep::kNone:
+        weights.push_back(0);
+        break;
+    }
+  }
+  return weights.back();
+}
+
+// l_plus and swap of the variants of reverseDeleteAll
+static const int kPruneVariants = 3;
+static const bool kVariantLPlus[kPruneVariants] = {false, true, true};
+static const bool kVariantSwap[kPruneVariants] = {true, true, false};
+
+// Edges kept by one or more variants, with the ends of the edges in counts.
+// Lists started by kLargest go on with the counts of the list they came from,
+// as in prune.
+struct KeptEdges {
+  std::list<std::shared_ptr<Edge>> edges;
+  std::shared_ptr<IncidenceCounts> counts;
+};
+
+// Edges and weights of the variants of prune in one walk. Variants which kept
+// the same edges so far share a list, and it is only copied once they take
+// different steps.
+struct PruneVariants {
+  std::list<KeptEdges> lists;  // owns the edge lists
+  KeptEdges* edges[kPruneVariants];
+  double weight[kPruneVariants];
+
+  KeptEdges* newList(std::shared_ptr<IncidenceCounts> counts) {
+    lists.push_back(KeptEdges{{}, std::move(counts)});
+    return &lists.back();
+  }
+
+  KeptEdges* copyList(const KeptEdges& kept) {
+    lists.push_back(
+        KeptEdges{kept.edges, std::make_shared<IncidenceCounts>(*kept.counts)});
+    return &lists.back();
+  }
+};
+
+// A subset on the stack of pruneVariants, with what its variants do
+struct VariantsFrame {
+  VariantsFrame(const Subset* subset, unsigned mask)
+      : s(subset), variants(mask) {}
+
+  const Subset* s;
+  unsigned variants;  // bit mask of the variants pruning s
+  int stage = 0;      // parents pruned so far
+  unsigned to1 = 0, to2 = 0;  // variants going on to p1 and p2
+  PruneStep step[kPruneVariants] = {};
+  const std::shared_ptr<Edge>* edge[kPruneVariants] = {};
+  KeptEdges* start2[kPruneVariants] = {};  // lists of p1 and p2 for kLargest
+  KeptEdges* edges1[kPruneVariants] = {};
+  double w1[kPruneVariants] = {};
+};
+
+// Finds the steps of the variants of frame, as prune would, and sets up their
+// lists for the parents. Sets the weight of variants which stop at s.
+static void beginVariants(VariantsFrame& frame, PruneVariants& state) {
+  const Subset* s = frame.s;
+  unsigned variants = frame.variants;
+
   // Base case is that s does not have a parent
   if (s->getParent1() == nullptr) {
+    for (int v = 0; v < kPruneVariants; v++) {
+      if (variants >> v & 1) state.weight[v] = 0;
+    }
     return;
   }
 
-  // Otherwise find parents and number of endpoints
-  std::shared_ptr<Subset> p1 = s->getParent1(), p2 = s->getParent2();
-  int u = tied_S->getVertices().back();
+  const Subset *p1 = s->getParent1(), *p2 = s->getParent2();
+  int connected1[kPruneVariants], connected2[kPruneVariants];
+  PruneStep* step = frame.step;
+  const std::shared_ptr<Edge>** edge = frame.edge;
+  for (int v = 0; v < kPruneVariants; v++) {
+    if (!(variants >> v & 1)) continue;
+    edge[v] = &s->getEdge();
+    if (kVariantLPlus[v] && kVariantSwap[v] && s->getAltEdge() != nullptr) {
+      edge[v] = &s->getAltEdge();
+    }
 
-  // Find if p1 has another incident edge already included and searched pruned
-  // edges
-  int connected1 = 0, connectedTied1 = 0;
-  std::shared_ptr<Edge> connectedE1 = nullptr;
-  bool inp1 = false;
-  for (auto v : p1->getVertices()) {
-    for (auto e : edges) {
-      if ((e->getHead() == v) || (e->getTail() == v)) {
-        connectedE1 = e;
-        connected1 += 1;
+    // Degrees only depend on the list, so count them once per list
+    int u = 0;
+    while (u < v && !((variants >> u & 1) && state.edges[u] == state.edges[v]))
+      u++;
+    if (u < v) {
+      connected1[v] = connected1[u];
+      connected2[v] = connected2[u];
+    } else {
+      connected1[v] = state.edges[v]->counts->count(p1);
+      connected2[v] = state.edges[v]->counts->count(p2);
+    }
+
+    bool p1active = p1->getActive() && !(kVariantLPlus[v] && p1->getTied());
+    bool p2active = p2->getActive() && !(kVariantLPlus[v] && p2->getTied());
+    step[v] = pruneStep(p1active, p2active, connected1[v], connected2[v],
+                        state.edges[v]->edges.empty());
+  }
+
+  // Variants sharing a list but not the step go on with their own copy
+  KeptEdges* next[kPruneVariants];
+  for (int v = 0; v < kPruneVariants; v++) {
+    if (!(variants >> v & 1)) continue;
+    next[v] = state.edges[v];
+    for (int u = 0; u < v; u++) {
+      if (!(variants >> u & 1) || state.edges[u] != state.edges[v]) continue;
+      if (step[u] == step[v] && *edge[u] == *edge[v]) {
+        next[v] = next[u];
+        break;
       }
+      if (next[v] == state.edges[v]) next[v] = nullptr;
+    }
+    if (next[v] == nullptr) next[v] = state.copyList(*state.edges[v]);
+  }
+
+  // Largest variants walk each parent from a new empty list
+  for (int v = 0; v < kPruneVariants; v++) {
+    if (!(variants >> v & 1)) continue;
+    int u = 0;  // first variant on the same list
+    while (!((variants >> u & 1) && next[u] == next[v])) u++;
+    state.edges[v] = next[v];
+    switch (step[v]) {
+      case PruneStep::kBoth:
+        if (u == v) {
+          next[v]->edges.push_back(*edge[v]);
+          next[v]->counts->add(*edge[v]);
+        }
+        frame.to1 |= 1u << v;
+        frame.to2 |= 1u << v;
+        break;
+      case PruneStep::kParent1:
+        frame.to1 |= 1u << v;
+        break;
+      case PruneStep::kParent2:
+        frame.to2 |= 1u << v;
+        break;
+      case PruneStep::kLargest:
+        state.edges[v] =
+            u == v ? state.newList(next[v]->counts) : state.edges[u];
+        frame.start2[v] =
+            u == v ? state.newList(next[v]->counts) : frame.start2[u];
+        frame.to1 |= 1u << v;
+        frame.to2 |= 1u << v;
+        break;
+      case PruneStep::kNone:
+        state.weight[v] = 0;
+        break;
+    }
+  }
+}
+
+// Keeps the weights of p1 and moves largest variants on to their list for p2
+static void parent1Variants(VariantsFrame& frame, PruneVariants& state) {
+  for (int v = 0; v < kPruneVariants; v++) {
+    if (!(frame.to1 >> v & 1)) continue;
+    frame.w1[v] = state.weight[v];
+    if (frame.step[v] == PruneStep::kLargest) {
+      frame.edges1[v] = state.edges[v];
+      state.edges[v] = frame.start2[v];
     }
-    if (v == u) inp1 = true;
-    for (auto e : prunedE) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connectedTied1 += 1;
+  }
+}
+
+// Sets the weights of the variants of frame from those of the parents
+static void endVariants(const VariantsFrame& frame, PruneVariants& state) {
+  for (int v = 0; v < kPruneVariants; v++) {
+    if (!(frame.variants >> v & 1)) continue;
+    switch (frame.step[v]) {
+      case PruneStep::kBoth:
+        state.weight[v] =
+            frame.w1[v] + state.weight[v] + (*frame.edge[v])->getWeight();
+        break;
+      case PruneStep::kParent1:
+        state.weight[v] = frame.w1[v];
+        break;
+      case PruneStep::kLargest:
+        if (frame.w1[v] > state.weight[v]) {
+          state.edges[v] = frame.edges1[v];
+          state.weight[v] = frame.w1[v];
+        }
+        break;
+      case PruneStep::kParent2:
+      case PruneStep::kNone:
+        break;
     }
   }
+}
 
-  // Find if p2 has another incident edge already included and search pruned
-  // edges
-  int connected2 = 0, connectedTied2 = 0;
-  std::shared_ptr<Edge> connectedE2 = nullptr;
-  bool inp2 = false;
-  for (auto v : p2->getVertices()) {
-    for (auto e : edges) {
-      if ((e->getHead() == v) || (e->getTail() == v)) {
-        connectedE2 = e;
-        connected2 += 1;
+// prune of s for each variant in the bit mask variants, with the same steps as
+// prune. Sets their weight.
+static void pruneVariants(const Subset* s, unsigned variants,
+                          PruneVariants& state) {
+  std::vector<VariantsFrame> stack;
+  stack.emplace_back(s, variants);
+  while (!stack.empty()) {
+    VariantsFrame& frame = stack.back();
+    const Subset* t = frame.s;
+    if (frame.stage == 0) {
+      beginVariants(frame, state);
+      if (t->getParent1() == nullptr) {
+        stack.pop_back();
+        continue;
+      }
+      frame.stage = 1;
+      if (frame.to1 != 0) {
+        unsigned to1 = frame.to1;
+        stack.emplace_back(t->getParent1(), to1);
+        continue;
       }
     }
-    if (v == u) inp2 = true;
-    for (auto e : prunedE) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connectedTied2 += 1;
+    if (frame.stage == 1) {
+      parent1Variants(frame, state);
+      frame.stage = 2;
+      if (frame.to2 != 0) {
+        unsigned to2 = frame.to2;
+        stack.emplace_back(t->getParent2(), to2);
+        continue;
+      }
     }
+    endVariants(frame, state);
+    stack.pop_back();
+  }
+}
+
+// One subset s of the family of root in maxPrunedS, with kept holding the
+// ends of edges and pruned those of prunedE. Pushes the parents to go on to
+// onto stack, and subsets added to prunedS share root.
+static void maxPrunedSStep(const std::shared_ptr<Subset>& root, Subset* s,
+                           std::list<std::shared_ptr<Edge>>& edges,
+                           std::shared_ptr<Subset>& tied_S,
+                           std::vector<std::shared_ptr<Subset>>& prunedS,
+                           std::vector<std::shared_ptr<Edge>>& prunedE,
+                           IncidenceCounts& kept, IncidenceCounts& pruned,
+                           SubsetStack& stack) {
+  // Base case is that s does not have a parent
+  if (s->getParent1() == nullptr) {
+    return;
   }
 
+  // Otherwise find parents and number of endpoints
+  Subset *p1 = s->getParent1(), *p2 = s->getParent2();
+  int u = tied_S->getVertices().back();
+
+  // Find if p1 and p2 have another incident edge already included and
+  // search pruned edges
+  int connected1 = kept.count(p1), connectedTied1 = pruned.count(p1);
+  int connected2 = kept.count(p2), connectedTied2 = pruned.count(p2);
+  bool inp1 = kept.contains(p1, u), inp2 = kept.contains(p2, u);
+
   // Find if active. If l_plus = true don't include those that tied
   bool p1active = p1->getActive();
   bool p2active = p2->getActive();
@@ -155,131 +427,134 @@ void maxPrunedS(std::shared_ptr<Subset>& s,
     // std::cout << "Case 1 \n";
     // std::cout << "Edge added " << *(s->getEdge()) << "\n";
     edges.push_back(s->getEdge());
-    maxPrunedS(p1, edges, tied_S, prunedS, prunedE);
-    maxPrunedS(p2, edges, tied_S, prunedS, prunedE);
+    kept.add(s->getEdge());
+    stack.push_back(p2);
+    stack.push_back(p1);
   }
 
   // Else if p1 is active, recurse on p1 - check whether p2 would have been
   // pruned in other case
   else if ((p1active) || (connected1 > 1)) {
     // std::cout << "Case 2 \n";
-    if ((connectedTied2 > 0) || (tied_S == p2)) {
+    if ((connectedTied2 > 0) || (tied_S.get() == p2)) {
       prunedE.insert(prunedE.begin(), s->getEdge());
-      prunedS.insert(prunedS.begin(), p2);
+      prunedS.insert(prunedS.begin(), std::shared_ptr<Subset>(root, p2));
+      pruned.add(s->getEdge());
     }
-    maxPrunedS(p1, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p1);
   }
 
   // Else if p2 is active, recurse on p2 - check whether p1 would have been
   // pruned in other case
   else if ((p2active) || (connected2 > 1)) {
     // std::cout << "Case 3 \n";
-    if ((connectedTied1 > 0) || (tied_S == p1)) {
+    if ((connectedTied1 > 0) || (tied_S.get() == p1)) {
       prunedE.insert(prunedE.begin(), s->getEdge());
-      prunedS.insert(prunedS.begin(), p1);
+      prunedS.insert(prunedS.begin(), std::shared_ptr<Subset>(root, p1));
+      pruned.add(s->getEdge());
     }
-    maxPrunedS(p2, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p2);
   }
 
   // Else if p1 == tied_S and connected by a single edge - would have kept
   // otherwise
-  else if ((p1 == tied_S) && (connected1 == 1)) {
+  else if ((p1 == tied_S.get()) && (connected1 == 1)) {
     // std::cout << "Case 4 \n";
-    prunedE.insert(prunedE.begin(), connectedE1);
-    prunedS.insert(prunedS.begin(), p1);
+    prunedE.insert(prunedE.begin(), lastIncident(kept, p1, edges));
+    prunedS.insert(prunedS.begin(), std::shared_ptr<Subset>(root, p1));
   }
 
   // Else if p1 == tied_S and p2 is inactive and connected by a single edge
-  else if ((p1 == tied_S) && (connected2 == 1)) {
+  else if ((p1 == tied_S.get()) && (connected2 == 1)) {
     // std::cout << "Case 5 \n";
-    prunedE.push_back(connectedE2);
-    prunedS.push_back(p2);
+    prunedE.push_back(lastIncident(kept, p2, edges));
+    prunedS.push_back(std::shared_ptr<Subset>(root, p2));
     prunedE.push_back(s->getEdge());
-    prunedS.push_back(p1);
+    prunedS.push_back(std::shared_ptr<Subset>(root, p1));
   }
 
   // Else if p1 == tied_S and connected by a single edge - would have kept
   // otherwise
-  else if ((p2 == tied_S) && (connected2 == 1)) {
+  else if ((p2 == tied_S.get()) && (connected2 == 1)) {
     // std::cout << "Case 6 \n";
-    prunedE.insert(prunedE.begin(), connectedE2);
-    prunedS.insert(prunedS.begin(), p2);
+    prunedE.insert(prunedE.begin(), lastIncident(kept, p2, edges));
+    prunedS.insert(prunedS.begin(), std::shared_ptr<Subset>(root, p2));
   }
 
   // Else if p2 == tied_S and p1 is inactive and connected by a single edge
-  else if ((p2 == tied_S) && (connected1 == 1)) {
+  else if ((p2 == tied_S.get()) && (connected1 == 1)) {
     // std::cout << "Case 7 \n";
-    prunedE.push_back(connectedE1);
-    prunedS.push_back(p1);
+    prunedE.push_back(lastIncident(kept, p1, edges));
+    prunedS.push_back(std::shared_ptr<Subset>(root, p1));
     prunedE.push_back(s->getEdge());
-    prunedS.push_back(p2);
+    prunedS.push_back(std::shared_ptr<Subset>(root, p2));
   }
 
   // Else if both p1 and p2 are inactive then we need to find which one contains
   // test_s
   else if (inp1) {
-    maxPrunedS(p1, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p1);
   } else if (inp2) {
-    maxPrunedS(p2, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p2);
   }
 }
 
-// Find path of maximal pruned subsets that are not pruned when s uses alt edge
-void maxPrunedE(std::shared_ptr<Subset>& s,
+// Find path of maximal pruned subsets that are not pruned when s is marked
+// active
+void maxPrunedS(std::shared_ptr<Subset>& s,
                 std::list<std::shared_ptr<Edge>>& edges,
                 std::shared_ptr<Subset>& tied_S,
                 std::vector<std::shared_ptr<Subset>>& prunedS,
                 std::vector<std::shared_ptr<Edge>>& prunedE) {
+  IncidenceCounts kept(s.get(), edges);
+  IncidenceCounts pruned(s.get(), {prunedE.begin(), prunedE.end()});
+  SubsetStack stack = {s.get()};
+  while (!stack.empty()) {
+    Subset* t = stack.back();
+    stack.pop_back();
+    maxPrunedSStep(s, t, edges, tied_S, prunedS, prunedE, kept, pruned, stack);
+  }
+}
+
+// One subset s of the family of root in maxPrunedE, with kept holding the
+// ends of edges and pruned those of prunedE. Pushes the parents to go on to
+// onto stack, and subsets added to prunedS share root.
+static void maxPrunedEStep(const std::shared_ptr<Subset>& root, Subset* s,
+                           std::list<std::shared_ptr<Edge>>& edges,
+                           std::shared_ptr<Subset>& tied_S,
+                           std::vector<std::shared_ptr<Subset>>& prunedS,
+                           std::vector<std::shared_ptr<Edge>>& prunedE,
+                           IncidenceCounts& kept, IncidenceCounts& pruned,
+                           SubsetStack& stack) {
   // Base case is that s does not have a parent
   if (s->getParent1() == nullptr) {
     return;
   }
 
   // Otherwise find parents and number of endpoints
-  std::shared_ptr<Subset> p1 = s->getParent1(), p2 = s->getParent2();
+  Subset *p1 = s->getParent1(), *p2 = s->getParent2();
   std::shared_ptr<Edge> alt_e = tied_S->getAltEdge();
   int u = tied_S->getVertices().back();
 
-  // Find if p1 has another incident edge already included and searched pruned
-  // edges
-  int connected1 = 0, connectedTied1 = 0;
-  bool inp1 = false;
-  for (auto v : p1->getVertices()) {
-    for (auto e : edges) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connected1 += 1;
-    }
-    if (v == u) inp1 = true;
-    for (auto e : prunedE) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connectedTied1 += 1;
-    }
-    if ((alt_e->getHead() == v) || (alt_e->getTail() == v)) connectedTied1 += 1;
-  }
-
-  // Find if p2 has another incident edge already included and search pruned
-  // edges plus the alt edge
-  int connected2 = 0, connectedTied2 = 0;
-  bool inp2 = false;
-  for (auto v : p2->getVertices()) {
-    for (auto e : edges) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connected2 += 1;
-    }
-    if (v == u) inp2 = true;
-    for (auto e : prunedE) {
-      if ((e->getHead() == v) || (e->getTail() == v)) connectedTied2 += 1;
-    }
-    if ((alt_e->getHead() == v) || (alt_e->getTail() == v)) connectedTied2 += 1;
-  }
+  // Find if p1 and p2 have another incident edge already included and
+  // search pruned edges plus the alt edge
+  int connected1 = kept.count(p1),
+      connectedTied1 = pruned.count(p1) + kept.ends(p1, alt_e);
+  int connected2 = kept.count(p2),
+      connectedTied2 = pruned.count(p2) + kept.ends(p2, alt_e);
+  bool inp1 = kept.contains(p1, u), inp2 = kept.contains(p2, u);
 
   // Find if active. If l_plus = true don't include those that tied
   bool p1active = p1->getActive();
   bool p2active = p2->getActive();
 
   // If s == tied_S then keep e and recurse on both parents
-  if (s == tied_S) {
+  if (s == tied_S.get()) {
     edges.push_back(s->getEdge());
-    maxPrunedE(p1, edges, tied_S, prunedS, prunedE);
-    prunedE.push_back(alt_e);  // Push alt_e onto back of path then continue
-    maxPrunedE(p2, edges, tied_S, prunedS, prunedE);
+    kept.add(s->getEdge());
+    stack.push_back(p2);
+    stack.push_back(nullptr);  // Push alt_e onto back of path in between
+    stack.push_back(p1);
   }
 
   // If p1 and p2 are active or neither needs to be pruned, add edge between and
@@ -287,8 +562,9 @@ void maxPrunedE(std::shared_ptr<Subset>& s,
   else if (((p1active && p2active) || (p1active && connected2)) ||
            (p2active && connected1) || ((connected1 > 0) && (connected2 > 0))) {
     edges.push_back(s->getEdge());
-    maxPrunedE(p1, edges, tied_S, prunedS, prunedE);
-    maxPrunedE(p2, edges, tied_S, prunedS, prunedE);
+    kept.add(s->getEdge());
+    stack.push_back(p2);
+    stack.push_back(p1);
   }
 
   // Else if p1 is active, recurse on p1 - check whether p2 would have been
@@ -296,9 +572,10 @@ void maxPrunedE(std::shared_ptr<Subset>& s,
   else if ((p1active) || (connected1 > 1)) {
     if (connectedTied2 > 0) {
       prunedE.push_back(s->getEdge());
-      prunedS.push_back(p2);
+      prunedS.push_back(std::shared_ptr<Subset>(root, p2));
+      pruned.add(s->getEdge());
     }
-    maxPrunedE(p1, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p1);
   }
 
   // Else if p2 is active, recurse on p2 - check whether p1 would have been
@@ -306,17 +583,40 @@ void maxPrunedE(std::shared_ptr<Subset>& s,
   else if ((p2active) || (connected2 > 1)) {
     if (connectedTied1 > 0) {
       prunedE.push_back(s->getEdge());
-      prunedS.push_back(p1);
+      prunedS.push_back(std::shared_ptr<Subset>(root, p1));
+      pruned.add(s->getEdge());
     }
-    maxPrunedE(p2, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p2);
   }
 
   // Else if both p1 and p2 are inactive then we need to find which one contains
   // test_s
   else if (inp1) {
-    maxPrunedE(p1, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p1);
   } else if (inp2) {
-    maxPrunedE(p2, edges, tied_S, prunedS, prunedE);
+    stack.push_back(p2);
+  }
+}
+
+// Find path of maximal pruned subsets that are not pruned when s uses alt edge
+void maxPrunedE(std::shared_ptr<Subset>& s,
+                std::list<std::shared_ptr<Edge>>& edges,
+                std::shared_ptr<Subset>& tied_S,
+                std::vector<std::shared_ptr<Subset>>& prunedS,
+                std::vector<std::shared_ptr<Edge>>& prunedE) {
+  IncidenceCounts kept(s.get(), edges);
+  IncidenceCounts pruned(s.get(), {prunedE.begin(), prunedE.end()});
+  SubsetStack stack = {s.get()};
+  while (!stack.empty()) {
+    Subset* t = stack.back();
+    stack.pop_back();
+    if (t == nullptr) {
+      prunedE.push_back(tied_S->getAltEdge());
+      pruned.add(tied_S->getAltEdge());
+    } else {
+      maxPrunedEStep(s, t, edges, tied_S, prunedS, prunedE, kept, pruned,
+                     stack);
+    }
   }
 }
 
@@ -340,6 +640,211 @@ double reverseDelete(std::list<std::shared_ptr<Subset>>& subsets,
   return largest;
 }
 
+ReverseDeleteWeights reverseDeleteAll(
+    std::list<std::shared_ptr<Subset>>& subsets) {
+  double largest[kPruneVariants] = {-INT_MAX, -INT_MAX, -INT_MAX};
+  for (const auto& s : subsets) {
+    PruneVariants state;
+    auto edges = state.newList(std::make_shared<IncidenceCounts>(
+        s.get(), std::list<std::shared_ptr<Edge>>()));
+    for (int v = 0; v < kPruneVariants; v++) state.edges[v] = edges;
+    pruneVariants(s.get(), (1u << kPruneVariants) - 1, state);
+    for (int v = 0; v < kPruneVariants; v++) {
+      if (state.weight[v] > largest[v]) largest[v] = state.weight[v];
+    }
+  }
+  return ReverseDeleteWeights{largest[0], largest[1], largest[2]};
+}
+
+IncrementalPrune::IncrementalPrune(const std::shared_ptr<Subset>& s)
+    : root_(s) {
+  // Number the subsets of s, parents after their child
+  subsets_.push_back(s.get());
+  child_.push_back(-1);
+  for (size_t i = 0; i < subsets_.size(); i++) {
+    const Subset* t = subsets_[i];
+    index_[t] = i;
+    parent1_.push_back(-1);
+    parent2_.push_back(-1);
+    if (t->getParent1() == nullptr) continue;
+    parent1_[i] = subsets_.size();
+    subsets_.push_back(t->getParent1());
+    child_.push_back(i);
+    parent2_[i] = subsets_.size();
+    subsets_.push_back(t->getParent2());
+    child_.push_back(i);
+  }
+  records_.resize(subsets_.size());
+
+  path_.reset(new IncidenceCounts(s.get(), {}));
+  changed_.reset(new IncidenceCounts(*path_));
+  records_[0].no_edges = true;
+  walk(0);
+}
+
+IncrementalPrune::~IncrementalPrune() {}
+
+double IncrementalPrune::weight() const { return records_[0].weight; }
+
+double IncrementalPrune::swapEdges(const std::shared_ptr<Subset>& t) {
+  t->swapEdges();
+
+  // Only the edge prune keeps at t changes
+  int i = index_.at(t.get());
+  if (records_[i].visited) walk(i);
+  return weight();
+}
+
+double IncrementalPrune::setInactive(const std::shared_ptr<Subset>& t) {
+  t->setActive(false);
+
+  // Only the step of the subset whose parent is t changes
+  int i = child_[index_.at(t.get())];
+  if (i >= 0 && records_[i].visited) walk(i);
+  return weight();
+}
+
+// Walks prune again from subset from, which was reached by the walk. Subsets
+// further on are only walked again if the edges kept before them changed.
+void IncrementalPrune::walk(int from) {
+  // Edges kept before from
+  std::vector<std::shared_ptr<Edge>> path_edges, changed_edges;
+  for (int a = child_[from]; a >= 0; a = child_[a]) {
+    if (records_[a].step != PruneStep::kBoth) continue;
+    path_->add(records_[a].kept);
+    path_edges.push_back(records_[a].kept);
+  }
+
+  // Walk in the order of prune, each subset with whether edges were kept
+  // before it
+  std::vector<std::pair<int, bool>> stack = {{from, records_[from].no_edges}};
+  std::vector<int> walked;
+  while (!stack.empty()) {
+    int i = stack.back().first;
+    bool no_edges = stack.back().second;
+    stack.pop_back();
+    Record& record = records_[i];
+    const Subset* t = subsets_[i];
+
+    // The walk from t is the same as before if it starts from the same edges
+    if (i != from && record.visited && record.no_edges == no_edges &&
+        changed_->count(*t) == 0) {
+      continue;
+    }
+
+    PruneStep step = PruneStep::kNone;
+    std::shared_ptr<Edge> kept = nullptr;
+    if (t->getParent1() != nullptr) {
+      const Subset &p1 = *t->getParent1(), &p2 = *t->getParent2();
+      step = pruneStep(p1.getActive(), p2.getActive(), path_->count(p1),
+                       path_->count(p2), no_edges);
+      if (step == PruneStep::kBoth) kept = t->getEdge();
+    }
+
+    // Edges kept further on are counted as changed where this one changed
+    if (record.visited && record.kept != kept) {
+      for (auto& e : {record.kept, kept}) {
+        if (e == nullptr) continue;
+        changed_->add(e);
+        changed_edges.push_back(e);
+      }
+    }
+    if (kept != nullptr) {
+      path_->add(kept);
+      path_edges.push_back(kept);
+    }
+
+    // Parents no longer reached keep nothing from before
+    bool to1 = step == PruneStep::kBoth || step == PruneStep::kParent1 ||
+               step == PruneStep::kLargest;
+    bool to2 = step == PruneStep::kBoth || step == PruneStep::kParent2 ||
+               step == PruneStep::kLargest;
+    if (record.visited) {
+      PruneStep old = record.step;
+      if (!to1 && (old == PruneStep::kBoth || old == PruneStep::kParent1 ||
+                   old == PruneStep::kLargest)) {
+        forget(parent1_[i]);
+      }
+      if (!to2 && (old == PruneStep::kBoth || old == PruneStep::kParent2 ||
+                   old == PruneStep::kLargest)) {
+        forget(parent2_[i]);
+      }
+    }
+
+    record.visited = true;
+    record.no_edges = no_edges;
+    record.step = step;
+    record.kept = kept;
+    walked.push_back(i);
+
+    // Parents go on the stack in reverse, so p1 is walked before p2
+    bool parent_no_edges = step == PruneStep::kLargest ||
+                           (step != PruneStep::kBoth && no_edges);
+    if (to2) stack.push_back({parent2_[i], parent_no_edges});
+    if (to1) stack.push_back({parent1_[i], parent_no_edges});
+  }
+
+  // Weights of the subsets walked again, parents first, then of the path back
+  for (auto it = walked.rbegin(); it != walked.rend(); ++it) {
+    records_[*it].weight = recordWeight(*it);
+  }
+  for (int a = child_[from]; a >= 0; a = child_[a]) {
+    records_[a].weight = recordWeight(a);
+  }
+
+  for (auto& e : path_edges) path_->remove(e);
+  for (auto& e : changed_edges) changed_->remove(e);
+}
+
+// Marks the subsets reached from subset from as no longer reached
+void IncrementalPrune::forget(int from) {
+  std::vector<int> stack = {from};
+  while (!stack.empty()) {
+    Record& record = records_[stack.back()];
+    int i = stack.back();
+    stack.pop_back();
+    if (!record.visited) continue;
+    record.visited = false;
+    switch (record.step) {
+      case PruneStep::kBoth:
+      case PruneStep::kLargest:
+        stack.push_back(parent1_[i]);
+        stack.push_back(parent2_[i]);
+        break;
+      case PruneStep::kParent1:
+        stack.push_back(parent1_[i]);
+        break;
+      case PruneStep::kParent2:
+        stack.push_back(parent2_[i]);
+        break;
+      case PruneStep::kNone:
+        break;
+    }
+  }
+}
+
+// Weight of prune from subset i, as prune adds it up
+double IncrementalPrune::recordWeight(int i) const {
+  const Record& record = records_[i];
+  switch (record.step) {
+    case PruneStep::kBoth:
+      return records_[parent1_[i]].weight + records_[parent2_[i]].weight +
+             record.kept->getWeight();
+    case PruneStep::kParent1:
+      return records_[parent1_[i]].weight;
+    case PruneStep::kParent2:
+      return records_[parent2_[i]].weight;
+    case PruneStep::kLargest: {
+      double w1 = records_[parent1_[i]].weight,
+             w2 = records_[parent2_[i]].weight;
+      return w1 > w2 ? w1 : w2;
+    }
+    case PruneStep::kNone:
+      break;
+  }
+  return 0;
+}
+
 /* ------------------------- ALTERNATE FUNCTIONS --------------------------*/
 
 double reverseDelete(std::list<std::shared_ptr<Subset>>& subsets, bool l_plus,
@@ -157,24 +157,20 @@ double readNodeCoordSection(const std::string &filename, Graph &graph) {
     node_coordinates.emplace_back(NodeCoord{node_id, x, y});
   }
 
-  // Build the complete graph from the list of node coordinates
-  double total_edge_weight = 0;
-  int edges_added = 0;
-  for (size_t head = 0; head < node_coordinates.size(); head++) {
-    for (size_t tail = 0; tail < head; tail++) {
-      // Compute distance between two points
-      auto dx = node_coordinates[head].x - node_coordinates[tail].x;
-      auto dy = node_coordinates[head].y - node_coordinates[tail].y;
-      auto distance = std::sqrt(dx * dx + dy * dy);
-      graph.addEdge(head, tail, distance);
-      total_edge_weight += distance;
-      edges_added++;
-    }
-    graph.addEdge(head, head, 0.0);
-    edges_added++;
+  // The graph is the complete graph on the node coordinates, with an edge from
+  // each node to the ones before it and a loop. Its edges are made from the
+  // coordinates when they are needed.
+  std::vector<int> x, y;
+  for (const auto &node : node_coordinates) {
+    x.push_back(node.x);
+    y.push_back(node.y);
   }
+  graph.setCoordinates(std::move(x), std::move(y));
 
-  return total_edge_weight / edges_added;
+  // Mean edge weight, loops included, from the total the graph has added up
+  double edges_added = node_coordinates.size();
+  edges_added = edges_added * (edges_added + 1) / 2;
+  return graph.getWeight() / edges_added;
 }
 
 int readNodeScoreSection(const std::string &filename, Graph &graph) {
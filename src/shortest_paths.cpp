@@ -0,0 +1,90 @@
+#include "shortest_paths.h"
+
+#include <algorithm>
+
+#include "thread_pool.h"
+
+ShortestPaths::ShortestPaths(const Graph &G)
+    : graph_(G), coordinates_(G.getCoordinates()) {}
+
+// Length of a shortest path from i to j, from the closure if there is one and
+// else from the search kept for i
+double ShortestPaths::distance(int i, int j) {
+  if ((coordinates_ != nullptr) && coordinates_->has(i) &&
+      coordinates_->has(j)) {
+    return coordinates_->distance(i, j);
+  }
+  int s = graph_.getIndex(i), t = graph_.getIndex(j);
+  if (!table_.empty()) {
+    return table_[static_cast<size_t>(s) * graph_.getVertexIds().size() + t];
+  }
+  if (search_.source != s) {
+    search_.start(graph_, s);
+  }
+  search_.run(graph_, t);
+  return search_.dist[t];
+}
+
+// One full search from every vertex, each writing its own row. A Euclidean
+// graph needs none.
+void ShortestPaths::closure(int num_threads) {
+  if (coordinates_ != nullptr) {
+    return;
+  }
+  size_t n = graph_.getVertexIds().size();
+  graph_.getAdjacency();
+  std::vector<double> table(n * n);
+  ThreadPool::shared(num_threads).run(n, [&](int s) {
+    Search search;
+    search.start(graph_, s);
+    search.run(graph_, -1);
+    std::copy(search.dist.begin(), search.dist.end(), table.begin() + s * n);
+  });
+  table_ = std::move(table);
+}
+
+void ShortestPaths::Search::start(const Graph &G, int s) {
+  size_t n = G.getVertexIds().size();
+  source = s;
+  dist.assign(n, INT_MAX);
+  settled.assign(n, false);
+  heap.assign({});
+  heap.reserve(n);
+  dist[s] = 0;
+  heap.set(s, 0);
+}
+
+void ShortestPaths::Search::run(const Graph &G, int target) {
+  const Adjacency &adj = G.getAdjacency();
+  const std::vector<EdgeRecord> &records = G.getEdgeRecords();
+  while (((target < 0) || !settled[target]) && !heap.empty()) {
+    // settle the closest vertex reached
+    uint32_t u = heap.top();
+    heap.pop();
+    settled[u] = true;
+
+    // update distances of its neighbors
+    for (uint32_t k = adj.offsets[u]; k < adj.offsets[u + 1]; k++) {
+      const EdgeRecord &r = records[adj.edges[k]];
+      uint32_t v = r.head == u ? r.tail : r.head;
+      double d = dist[u] + r.weight;
+      if (!settled[v] && (d < dist[v])) {
+        dist[v] = d;
+        heap.set(v, d);
+      }
+    }
+  }
+}
+
+// Calculate tour length
+double getTourLength(ShortestPaths &paths, const std::vector<int> &tour) {
+  size_t n = tour.size();
+  double l = 0;
+  for (size_t i = 0; i + 1 < n; i++) {
+    l += paths.distance(tour[i], tour[i + 1]);
+  }
+  if (n > 0) {
+    l += paths.distance(tour[n - 1], tour[0]);
+  }
+  return l;
+}
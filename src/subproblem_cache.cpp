@@ -0,0 +1,41 @@
+#include "subproblem_cache.h"
+
+#include <functional>
+
+size_t SubproblemCache::KeyHash::operator()(const Key &key) const {
+  size_t hash = std::hash<double>()(key.budget);
+  for (int v : key.vertices) {
+    hash ^= std::hash<int>()(v) + 0x9e3779b97f4a7c15ull + (hash << 6) +
+            (hash >> 2);
+  }
+  return hash;
+}
+
+bool SubproblemCache::find(const std::vector<int> &vertices, double budget,
+                           SubproblemResult *result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = results_.find(Key{vertices, budget});
+  if (it == results_.end()) {
+    misses_++;
+    return false;
+  }
+  hits_++;
+  *result = it->second;
+  return true;
+}
+
+void SubproblemCache::insert(const std::vector<int> &vertices, double budget,
+                             const SubproblemResult &result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_.emplace(Key{vertices, budget}, result);
+}
+
+int SubproblemCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+int SubproblemCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
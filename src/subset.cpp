@@ -17,7 +17,11 @@
 // Constructor without parents
 Subset::Subset(int v, double pot, int pr) {
   // Set parents to NULL and vertices to v
-  vertices.push_back(v);
+  vertex.vertex = v;
+  first = &vertex;
+  last = &vertex;
+  size = 1;
+  id = -1;
   parent1 = NULL;
   parent2 = NULL;
 
@@ -29,35 +33,16 @@ Subset::Subset(int v, double pot, int pr) {
   tied = false;
 }
 
-// Constructor with parents but no alt edge
-Subset::Subset(const std::shared_ptr<Subset> p1,
-               const std::shared_ptr<Subset> p2,
-               const std::shared_ptr<Edge> e) {
-  vertices = p1->getVertices();
-  vertices.insert(vertices.end(), p2->getVertices().begin(),
-                  p2->getVertices().end());
-  parent1 = p1;
-  parent2 = p2;
-  edge = e;
-  alt_edge = NULL;
-
-  // Set values
-  active = true;
-  tied = false;
-  y_val = 0;
-  potential =
-      p1->getPotential() + p2->getPotential() - 2 * (p1->getY() + p2->getY());
-  edge_total = p1->getEdgeTotal() + p2->getEdgeTotal() + e->getWeight();
-  prize = p1->getPrize() + p2->getPrize();
-}
-
-// Constructor with parents and an alt edge
-Subset::Subset(const std::shared_ptr<Subset> p1,
-               const std::shared_ptr<Subset> p2, const std::shared_ptr<Edge> e,
+// Constructor with parents and an alt edge, if any
+Subset::Subset(Subset *p1, Subset *p2, const std::shared_ptr<Edge> e,
                const std::shared_ptr<Edge> alt_e) {
-  vertices = p1->getVertices();
-  vertices.insert(vertices.end(), p2->getVertices().begin(),
-                  p2->getVertices().end());
+  // Each subset is merged once, so the chains of p1 and p2 can be joined
+  // in place
+  p1->last->next = p2->first;
+  first = p1->first;
+  last = p2->last;
+  size = p1->size + p2->size;
+  id = -1;
   parent1 = p1;
   parent2 = p2;
   edge = e;
@@ -73,11 +58,6 @@ Subset::Subset(const std::shared_ptr<Subset> p1,
   prize = p1->getPrize() + p2->getPrize();
 }
 
-// Destructor
-Subset::~Subset() {
-  // Will ensure shared ptrs are safely deleted
-}
-
 // Swap function
 void Subset::swapEdges() {
   std::shared_ptr<Edge> temp_e = alt_edge;
@@ -90,7 +70,7 @@ void Subset::swapEdges() {
 // Print Function
 std::ostream &operator<<(std::ostream &out, const Subset &S) {
   out << "VERTICES: ";
-  for (auto v : S.vertices) {
+  for (auto v : S.getVertices()) {
     out << v << ", ";
   }
   out << "\n";
@@ -110,31 +90,31 @@ std::ostream &operator<<(std::ostream &out, const Subset &S) {
 std::shared_ptr<Subset> findMaxPotential(
     const std::list<std::shared_ptr<Subset>> &subsets, int p) {
   double max = -INT_MAX;
-  std::shared_ptr<Subset> max_s = NULL;
-
-  // Iterate through subsets to update max
-  for (auto s : subsets) {
-    // If best potential seen and has prize at least p
-    if ((s->getPotential() > max) && (s->getPrize() >= p)) {
-      max = s->getPotential();
-      max_s = s;
-    }
-
-    // Recurse on parents
-    if (s->getParent1() != NULL) {
-      // make list of parents
-      std::list<std::shared_ptr<Subset>> parents;
-      parents.push_back(s->getParent1());
-      parents.push_back(s->getParent2());
-
-      std::shared_ptr<Subset> test = findMaxPotential(parents);
-      if ((test != NULL) && (test->getPotential() > max)) {
-        max = test->getPotential();
-        max_s = test;
+  Subset *max_s = NULL;
+  const std::shared_ptr<Subset> *max_root = NULL;  // shares the family of max_s
+
+  // Iterate through subsets and their ancestors in depth first order to update
+  // max. Only the subsets themselves need prize at least p
+  std::vector<Subset *> stack;
+  for (auto &s : subsets) {
+    stack.push_back(s.get());
+    while (!stack.empty()) {
+      Subset *t = stack.back();
+      stack.pop_back();
+      if ((t->getPotential() > max) &&
+          (t->getPrize() >= (t == s.get() ? p : 0))) {
+        max = t->getPotential();
+        max_s = t;
+        max_root = &s;
+      }
+      if (t->getParent1() != NULL) {
+        stack.push_back(t->getParent2());
+        stack.push_back(t->getParent1());
       }
     }
   }
-  return max_s;
+  if (max_s == NULL) return NULL;
+  return std::shared_ptr<Subset>(*max_root, max_s);
 }
 
 // Find all maximal laminar sets in subsets (inc ancestors) that has potential
@@ -144,24 +124,24 @@ std::list<std::shared_ptr<Subset>> findHighPotential(
   // List to return
   std::list<std::shared_ptr<Subset>> highS;
 
-  // Iterate through subsets to add to list
-  for (auto s : subsets) {
-    // If s has high enough potential then add and don't recurse on parents
-    if (s->getPotential() > p + 0.0001) {
-      highS.push_back(s);
-    }
+  // Iterate through subsets and their ancestors in depth first order
+  std::vector<Subset *> stack;
+  for (auto &root : subsets) {
+    stack.push_back(root.get());
+    while (!stack.empty()) {
+      Subset *s = stack.back();
+      stack.pop_back();
+
+      // If s has high enough potential then add and don't go on to parents
+      if (s->getPotential() > p + 0.0001) {
+        highS.push_back(std::shared_ptr<Subset>(root, s));
+      }
 
-    // Otherwise recurse on parents (if non-null)
-    else if (s->getParent1() != NULL) {
-      // make list of parents
-      std::list<std::shared_ptr<Subset>> parents;
-      parents.push_back(s->getParent1());
-      parents.push_back(s->getParent2());
-
-      // Recurse and add lists to highS
-      std::list<std::shared_ptr<Subset>> test_list =
-          findHighPotential(parents, p);
-      highS.insert(highS.end(), test_list.begin(), test_list.end());
+      // Otherwise go on to parents (if non-null)
+      else if (s->getParent1() != NULL) {
+        stack.push_back(s->getParent2());
+        stack.push_back(s->getParent1());
+      }
     }
   }
   return highS;
@@ -183,31 +163,55 @@ std::shared_ptr<Subset> findMaxSuperset(
     return findMaxPotential(subsets);
   }
 
-  // Otherwise find parents and connecting edge(s)
-  std::shared_ptr<Subset> p1 = s->getParent1(), p2 = s->getParent2();
-  std::shared_ptr<Edge> e = s->getEdge(), alt_e = s->getAltEdge();
-
-  // If e or alt_e in edges then return s
-  for (auto test_e : edges) {
-    if ((test_e == e) || (test_e == alt_e)) {
-      return s;
+  // Ancestors of s to search, parents always after their child. A subset
+  // whose edge or alt_e is in edges is the answer for itself, so its parents
+  // are not searched
+  struct Search {
+    Subset *s;
+    int parent1 = -1, parent2 = -1;  // indices of searched parents
+  };
+  std::unordered_set<const Edge *> in_edges;
+  for (auto &e : edges) in_edges.insert(e.get());
+  std::vector<Search> order(1);
+  order[0].s = s.get();
+  for (size_t i = 0; i < order.size(); i++) {
+    Subset *t = order[i].s;
+    if ((t->getParent1() == NULL) || in_edges.count(t->getEdge().get()) ||
+        in_edges.count(t->getAltEdge().get())) {
+      continue;
     }
+    order[i].parent1 = order.size();
+    order[i].parent2 = order.size() + 1;
+    order.push_back(Search{t->getParent1()});
+    order.push_back(Search{t->getParent2()});
   }
 
-  // If not then check both parents to see which contains s and has highest
-  // potential
-  std::shared_ptr<Subset> s1 = findMaxSuperset(p1, edges);
-  std::shared_ptr<Subset> s2 = findMaxSuperset(p2, edges);
+  // Find the answer of each searched subset from those of its parents, NULL
+  // if it has no parents
+  std::vector<Subset *> best(order.size(), nullptr);
+  for (size_t i = order.size(); i-- > 0;) {
+    Subset *t = order[i].s;
+    if (t->getParent1() == NULL) continue;
+    if (order[i].parent1 < 0) {
+      best[i] = order[i].s;
+      continue;
+    }
 
-  if ((s1 != NULL) && (s1->getPotential() > s->getPotential())) {
-    return s1;
-  } else if ((s2 != NULL) && (s2->getPotential() > s->getPotential())) {
-    return s2;
-  } else if ((s1 == NULL) && (s2 == NULL)) {
-    return NULL;
-  } else {
-    return s;
+    // Check both parents to see which contains the edges and has highest
+    // potential
+    Subset *s1 = best[order[i].parent1], *s2 = best[order[i].parent2];
+    if ((s1 != nullptr) && (s1->getPotential() > t->getPotential())) {
+      best[i] = s1;
+    } else if ((s2 != nullptr) && (s2->getPotential() > t->getPotential())) {
+      best[i] = s2;
+    } else if ((s1 == nullptr) && (s2 == nullptr)) {
+      best[i] = nullptr;
+    } else {
+      best[i] = order[i].s;
+    }
   }
+  if (best[0] == nullptr) return NULL;
+  return std::shared_ptr<Subset>(s, best[0]);
 }
 
 // Pick routine which returns contiguous edges in s from vertex v with weight at
@@ -215,57 +219,82 @@ std::shared_ptr<Subset> findMaxSuperset(
 double pick(std::shared_ptr<Subset> &s, std::set<int> &visited, double limit,
             int v, std::list<std::shared_ptr<Edge>> &edges,
             std::shared_ptr<Edge> &last_e) {
-  // If s has no parents then just return because no edges to add
-  if (s->getParent1() == NULL) {
-    return 0;
-  }
+  // Subsets still to pick from, in the order the recursive routine would, and
+  // sums of the picks of both parents of a subset still to add (s == nullptr).
+  // Only picks along the last parent may set last_e
+  struct Pick {
+    Subset *s;
+    double limit;
+    int v;
+    bool sets_last_e;
+    double w;  // weight of the edge between the parents for sums
+  };
+  std::vector<Pick> picks;
+  std::vector<double> totals;
+  std::shared_ptr<Edge> temp_e = NULL;
+  picks.push_back(Pick{s.get(), limit, v, true, 0});
+  while (!picks.empty()) {
+    Pick next = picks.back();
+    picks.pop_back();
+
+    // Add the totals of p1 and p2 to the edge between them
+    if (next.s == nullptr) {
+      double total2 = totals.back();
+      totals.pop_back();
+      totals.back() = next.w + totals.back() + total2;
+      continue;
+    }
 
-  // Otherwise check which parent has v and which parent has the head of the
-  // connecting edge
-  int head = s->getEdge()->getHead();
-  bool vinP1 = false, headinP1 = false;
-  for (auto u : s->getParent1()->getVertices()) {
-    if (u == v) vinP1 = true;
-    if (u == head) headinP1 = true;
-  }
+    // If s has no parents then just return because no edges to add
+    Subset *t = next.s;
+    if (t->getParent1() == NULL) {
+      totals.push_back(0);
+      continue;
+    }
 
-  // Set p1, p2 and connecting vertices
-  std::shared_ptr<Subset> p1 = s->getParent1(), p2 = s->getParent2();
-  int v1 = head, v2 = s->getEdge()->getTail();
-  if (vinP1 == false) p1 = s->getParent2(), p2 = s->getParent1();
-  if (headinP1 == false) v1 = s->getEdge()->getTail(), v2 = head;
+    // Otherwise check which parent has v and which parent has the head of the
+    // connecting edge
+    int head = t->getEdge()->getHead();
+    bool vinP1 = false, headinP1 = false;
+    for (auto u : t->getParent1()->getVertices()) {
+      if (u == next.v) vinP1 = true;
+      if (u == head) headinP1 = true;
+    }
 
-  // Get weights
-  double w1 = p1->getEdgeTotal();
-  double w = s->getEdge()->getWeight();
+    // Set p1, p2 and connecting vertices
+    Subset *p1 = t->getParent1(), *p2 = t->getParent2();
+    int v1 = head, v2 = t->getEdge()->getTail();
+    if (vinP1 == false) p1 = t->getParent2(), p2 = t->getParent1();
+    if (headinP1 == false) v1 = t->getEdge()->getTail(), v2 = head;
 
-  // If w1 above limit then just recurse on p1
-  if (w1 > limit) {
-    return pick(p1, visited, limit, v, edges, last_e);
-  }
+    // Get weights
+    double w1 = p1->getEdgeTotal();
+    double w = t->getEdge()->getWeight();
 
-  // If w1+w above limit then just recurse on p1
-  else if (w1 + w > limit) {
-    last_e = s->getEdge();
-    std::shared_ptr<Edge> temp_e = NULL;
-    return pick(p1, visited, limit, v, edges, temp_e);
-  }
+    // If w1 above limit then just pick from p1
+    if (w1 > next.limit) {
+      picks.push_back(Pick{p1, next.limit, next.v, next.sets_last_e, 0});
+    }
 
-  // Otherwise recurse on both and add edge between p1 and p2
-  else {
-    // Add edge
-    double total = w;
-    edges.push_back(s->getEdge());
-    visited.insert(v2);
-    visited.insert(v1);
-
-    // Recurse on p1 and add all edges
-    std::shared_ptr<Edge> temp_e = NULL;
-    total += pick(p1, visited, w1 + 1, v1, edges, temp_e);
-
-    // Recurse on p2 and only add as many edges as possible
-    total += pick(p2, visited, limit - w1 - w, v2, edges, last_e);
-    return total;
+    // If w1+w above limit then just pick from p1
+    else if (w1 + w > next.limit) {
+      (next.sets_last_e ? last_e : temp_e) = t->getEdge();
+      picks.push_back(Pick{p1, next.limit, next.v, false, 0});
+    }
+
+    // Otherwise pick from both and add edge between p1 and p2
+    else {
+      // Add edge
+      edges.push_back(t->getEdge());
+      visited.insert(v2);
+      visited.insert(v1);
+
+      // Add all edges of p1, then only as many edges of p2 as possible
+      picks.push_back(Pick{nullptr, 0, 0, false, w});
+      picks.push_back(
+          Pick{p2, next.limit - w1 - w, v2, next.sets_last_e, 0});
+      picks.push_back(Pick{p1, w1 + 1, v1, false, 0});
+    }
   }
+  return totals.back();
 }
-
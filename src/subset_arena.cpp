@@ -0,0 +1,17 @@
+#include "subset_arena.h"
+
+SubsetArena::Family::~Family() {
+  for (Subset *subset : subsets) subset->~Subset();
+}
+
+void *SubsetArena::Family::allocate(size_t bytes, size_t alignment) {
+  size_t offset = (used_ + alignment - 1) / alignment * alignment;
+  if (offset + bytes > kBlockSize) {
+    // new[] aligns for any fundamental type, larger requests get their own
+    // block
+    blocks_.emplace_back(new char[bytes > kBlockSize ? bytes : kBlockSize]);
+    offset = 0;
+  }
+  used_ = offset + bytes;
+  return blocks_.back().get() + offset;
+}
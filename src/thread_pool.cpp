@@ -0,0 +1,69 @@
+#include "thread_pool.h"
+
+#include <map>
+#include <memory>
+
+ThreadPool::ThreadPool(int num_threads) {
+  for (int i = 1; i < num_threads; i++) workers_.emplace_back([this] { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+void ThreadPool::run(int num_tasks, const std::function<void(int)>& task) {
+  if (num_tasks <= 0) return;
+  if (workers_.empty() || num_tasks == 1) {
+    for (int i = 0; i < num_tasks; i++) task(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  task_ = &task;
+  num_tasks_ = num_tasks;
+  next_task_ = 0;
+  generation_++;
+  start_.notify_all();
+
+  runTasks(lock);
+  done_.wait(lock, [this] { return next_task_ == num_tasks_ && running_ == 0; });
+  task_ = nullptr;
+}
+
+void ThreadPool::work() {
+  unsigned seen = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+    if (stop_) return;
+    seen = generation_;
+    runTasks(lock);
+  }
+}
+
+void ThreadPool::runTasks(std::unique_lock<std::mutex>& lock) {
+  while (task_ != nullptr && next_task_ < num_tasks_) {
+    int i = next_task_++;
+    running_++;
+    const auto& task = *task_;
+    lock.unlock();
+    task(i);
+    lock.lock();
+    if (--running_ == 0 && next_task_ == num_tasks_) done_.notify_all();
+  }
+}
+
+ThreadPool& ThreadPool::shared(int num_threads) {
+  static std::mutex pools_mutex;
+  static std::map<int, std::unique_ptr<ThreadPool>> pools;
+  std::lock_guard<std::mutex> lock(pools_mutex);
+  auto& pool = pools[num_threads];
+  if (pool == nullptr) pool = std::make_unique<ThreadPool>(num_threads);
+  return *pool;
+}
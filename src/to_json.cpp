@@ -27,9 +27,19 @@ void to_json(nlohmann::json& j, const std::shared_ptr<Vertex>& v) {
   }
 }
 
+void to_json(nlohmann::json& j, const Graph& G) {
+  j = nlohmann::json::array();
+  for (auto id : G.getVertexIds()) {
+    j.push_back(nlohmann::json{{"id", id},
+                               {"prize", G.getVertexPrize(id)},
+                               {"neighbors", G.getIncEdges(id)}});
+  }
+}
+
 void to_json(nlohmann::json& j, const Subset& s) {
+  std::vector<int> vertices(s.getVertices().begin(), s.getVertices().end());
   j = nlohmann::json{
-      {"vertices", s.getVertices()},   {"active", s.getActive()},
+      {"vertices", vertices},          {"active", s.getActive()},
       {"potential", s.getPotential()}, {"y_val", s.getY()},
       {"tied", s.getTied()},           {"prize", s.getPrize()},
       {"edge", s.getEdge()},           {"alt_edge", s.getAltEdge()}};
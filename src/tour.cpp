@@ -0,0 +1,302 @@
+#include "tour.h"
+
+#include <algorithm>
+#include <climits>
+
+static const double kTourMargin = 1e-9;  // least gain of a move, against
+                                         // rounding
+static const int kTourNeighbors = 8;     // near vertices tried at each vertex
+
+// Tour being improved, as an order of the positions of the vertices in the
+// tour it started from
+struct TourState {
+  ShortestPaths &paths;
+  const std::vector<int> &ids;           // vertex ids by start position
+  std::vector<std::vector<int>> near;    // closest start positions, nearest
+                                         // first
+  std::vector<int> order;                // start positions in tour order
+  std::vector<int> pos;                  // place in order of each
+  double length;
+
+  double d(int a, int b) const { return paths.distance(ids[a], ids[b]); }
+  int next(int a, int dir) const {
+    int t = order.size();
+    return order[(pos[a] + dir + t) % t];
+  }
+};
+
+// Reverses the part of the tour from place from to place to, going forward,
+// or the rest of it if that is shorter, which gives the same tour
+static void reverse(TourState &s, int from, int to) {
+  int t = s.order.size();
+  int len = (to - from + t) % t + 1;
+  if (2 * len > t) {
+    std::swap(from, to);
+    from = (from + 1) % t, to = (to - 1 + t) % t;
+    len = t - len;
+  }
+  for (int k = 0; k < len / 2; k++) {
+    int i = (from + k) % t, j = (to - k + t) % t;
+    std::swap(s.order[i], s.order[j]);
+    s.pos[s.order[i]] = i, s.pos[s.order[j]] = j;
+  }
+}
+
+// Replaces edges (a, b) and (c, e) by (a, c) and (b, e), where b follows a and
+// e follows c in one direction and c is near a
+static bool twoOpt(TourState &s) {
+  int t = s.order.size();
+  bool improved = false;
+  for (int i = 0; i < t; i++) {
+    int a = s.order[i];
+    for (int dir : {1, -1}) {
+      int b = s.next(a, dir);
+      double dab = s.d(a, b);
+      for (int c : s.near[a]) {
+        double dac = s.d(a, c);
+        if (dac >= dab - kTourMargin) break;
+        int e = s.next(c, dir);
+        if ((c == b) || (e == a)) continue;
+        double delta = dac + s.d(b, e) - dab - s.d(c, e);
+        if (delta < -kTourMargin) {
+          if (dir == 1) {
+            reverse(s, s.pos[b], s.pos[c]);
+          } else {
+            reverse(s, s.pos[c], s.pos[b]);
+          }
+          s.length += delta;
+          improved = true;
+          break;
+        }
+      }
+    }
+  }
+  return improved;
+}
+
+// Moves a run of up to three vertices, either way round, between two vertices
+// next to each other in the tour, one of them near an end of the run
+static bool orOpt(TourState &s) {
+  int t = s.order.size();
+  bool improved = false;
+  for (int L = 1; (L <= 3) && (t >= L + 3); L++) {
+    for (int i = 0; i < t; i++) {
+      int s1 = s.order[i], sL = s.order[(i + L - 1) % t];
+      int p = s.order[(i - 1 + t) % t], nx = s.order[(i + L) % t];
+      double gain = s.d(p, s1) + s.d(sL, nx) - s.d(p, nx);
+      if (gain <= kTourMargin) continue;
+      auto inRun = [&](int v) { return (s.pos[v] - i + t) % t < L; };
+
+      // cheapest edge (u, w) to put the run in, u before w
+      double best = -kTourMargin;
+      int best_u = -1;
+      bool flip = false;
+      for (int end : {s1, sL}) {
+        for (int c : s.near[end]) {
+          if (inRun(c)) continue;
+          for (int dir : {1, -1}) {
+            int x = s.next(c, dir);
+            if (inRun(x)) continue;
+            int u = dir == 1 ? c : x, w = dir == 1 ? x : c;
+            double duw = s.d(u, w);
+            double kept = s.d(u, s1) + s.d(sL, w) - duw - gain;
+            double flipped = s.d(u, sL) + s.d(s1, w) - duw - gain;
+            if (kept < best) best = kept, best_u = u, flip = false;
+            if (flipped < best) best = flipped, best_u = u, flip = true;
+          }
+        }
+      }
+      if (best_u < 0) continue;
+
+      // take the run out and put it back after best_u
+      std::vector<int> run(s.order.begin() + i,
+                           s.order.begin() + std::min(i + L, t));
+      run.insert(run.end(), s.order.begin(),
+                 s.order.begin() + std::max(i + L - t, 0));
+      if (flip) std::reverse(run.begin(), run.end());
+      std::vector<int> moved;
+      moved.reserve(t);
+      for (int k = 0; k < t - L; k++) {
+        int v = s.order[(i + L + k) % t];
+        moved.push_back(v);
+        if (v == best_u) moved.insert(moved.end(), run.begin(), run.end());
+      }
+      s.order = std::move(moved);
+      for (int k = 0; k < t; k++) {
+        s.pos[s.order[k]] = k;
+      }
+      s.length += best;
+      improved = true;
+    }
+  }
+  return improved;
+}
+
+// Runs both kinds of moves until neither shortens the tour
+double improveTour(ShortestPaths &paths, std::vector<int> &tour,
+                   double length) {
+  int t = tour.size();
+  if (t < 4) {
+    return length;
+  }
+  TourState s{paths, tour, std::vector<std::vector<int>>(t),
+              std::vector<int>(t), std::vector<int>(t), length};
+  std::vector<std::pair<double, int>> row;
+  for (int i = 0; i < t; i++) {
+    s.order[i] = s.pos[i] = i;
+    row.clear();
+    for (int j = 0; j < t; j++) {
+      if (j != i) row.push_back({s.d(i, j), j});
+    }
+    size_t k = std::min<size_t>(kTourNeighbors, row.size());
+    std::partial_sort(row.begin(), row.begin() + k, row.end());
+    for (size_t q = 0; q < k; q++) {
+      s.near[i].push_back(row[q].second);
+    }
+  }
+
+  bool improved = true;
+  while (improved) {
+    improved = twoOpt(s);
+    improved = orOpt(s) || improved;
+  }
+
+  std::vector<int> improvedTour;
+  improvedTour.reserve(t);
+  for (auto i : s.order) {
+    improvedTour.push_back(tour[i]);
+  }
+  tour = std::move(improvedTour);
+  return s.length;
+}
+
+// Cheapest insertion by ratio of prize to added length, keeping the cheapest
+// edge for each vertex left. Only the vertices whose edge was split look at
+// the whole tour again.
+double insertVertices(const Graph &G, ShortestPaths &paths,
+                      std::vector<int> &tour, double length, double budget) {
+  if (tour.empty()) {
+    return length;
+  }
+
+  // successor in the tour by graph index
+  const std::vector<int> &vertices = G.getVertexIds();
+  std::vector<int> next(vertices.size(), -1);
+  for (size_t k = 0; k < tour.size(); k++) {
+    next[G.getIndex(tour[k])] = tour[(k + 1) % tour.size()];
+  }
+  auto added = [&](int u, int v) {
+    int w = next[G.getIndex(u)];
+    return paths.distance(u, v) + paths.distance(v, w) - paths.distance(u, w);
+  };
+
+  struct Candidate {
+    int id;
+    int prize;
+    double cost;  // least added length
+    int after;    // tour vertex to insert it after
+  };
+  auto cheapest = [&](Candidate &c) {
+    c.cost = INT_MAX;
+    int u = tour[0];
+    do {
+      double cost = added(u, c.id);
+      if (cost < c.cost) c.cost = cost, c.after = u;
+      u = next[G.getIndex(u)];
+    } while (u != tour[0]);
+  };
+  std::vector<Candidate> candidates;
+  for (size_t i = 0; i < vertices.size(); i++) {
+    int prize = G.getVertexPrize(vertices[i]);
+    if ((next[i] < 0) && (prize > 0)) {
+      candidates.push_back(Candidate{vertices[i], prize, 0, -1});
+      cheapest(candidates.back());
+    }
+  }
+
+  while (true) {
+    int best = -1;
+    double best_ratio = 0;
+    for (size_t k = 0; k < candidates.size(); k++) {
+      const Candidate &c = candidates[k];
+      if (length + c.cost > budget) continue;
+      double ratio = c.prize / std::max(c.cost, kTourMargin);
+      if (ratio > best_ratio) best_ratio = ratio, best = k;
+    }
+    if (best < 0) break;
+
+    // insert between u and w, then look at the two new edges
+    Candidate v = candidates[best];
+    candidates.erase(candidates.begin() + best);
+    int u = v.after, w = next[G.getIndex(u)];
+    next[G.getIndex(v.id)] = w;
+    next[G.getIndex(u)] = v.id;
+    length += v.cost;
+    for (auto &c : candidates) {
+      if (c.after == u) {
+        cheapest(c);
+        continue;
+      }
+      double cost = added(u, c.id);
+      if (cost < c.cost) c.cost = cost, c.after = u;
+      cost = added(v.id, c.id);
+      if (cost < c.cost) c.cost = cost, c.after = v.id;
+    }
+  }
+
+  // read the tour off the successors
+  std::vector<int> grown = {tour[0]};
+  for (int u = next[G.getIndex(tour[0])]; u != tour[0];
+       u = next[G.getIndex(u)]) {
+    grown.push_back(u);
+  }
+  tour = std::move(grown);
+  return length;
+}
+
+double dropVertices(const Graph &G, ShortestPaths &paths,
+                    std::vector<int> &tour, double length, double budget) {
+  while ((length > budget) && (tour.size() > 1)) {
+    int t = tour.size(), drop = 0;
+    double drop_saving = 0, drop_ratio = 0;
+    for (int k = 0; k < t; k++) {
+      int p = tour[(k - 1 + t) % t], v = tour[k], n = tour[(k + 1) % t];
+      double saving =
+          paths.distance(p, v) + paths.distance(v, n) - paths.distance(p, n);
+      double ratio = G.getVertexPrize(v) / std::max(saving, kTourMargin);
+      if ((k == 0) || (ratio < drop_ratio)) {
+        drop = k, drop_saving = saving, drop_ratio = ratio;
+      }
+    }
+    tour.erase(tour.begin() + drop);
+    length -= drop_saving;
+  }
+  return length;
+}
+
+void buildTour(const Problem &problem, Solution &solution) {
+  const Graph &G = problem.graph;
+  ShortestPaths paths(G);
+  paths.closure(problem.options.num_threads);
+  solution.tour.clear();
+  if (!solution.path.empty()) {
+    solution.tour = tourList(solution.path);
+  }
+
+  // Shortening the tour can make room for more vertices
+  double length = getTourLength(paths, solution.tour);
+  length = improveTour(paths, solution.tour, length);
+  length = dropVertices(G, paths, solution.tour, length, problem.budget);
+  while (true) {
+    length = improveTour(paths, solution.tour, length);
+    size_t visited = solution.tour.size();
+    length = insertVertices(G, paths, solution.tour, length, problem.budget);
+    if (solution.tour.size() == visited) break;
+  }
+
+  solution.tour_length = getTourLength(paths, solution.tour);
+  solution.tour_prize = 0;
+  for (auto v : solution.tour) {
+    solution.tour_prize += G.getVertexPrize(v);
+  }
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include "disjoint_sets.h"
+
+#include <random>
+#include <vector>
+
+TEST(DisjointSets, singletons) {
+  DisjointSets sets(5);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(sets.find(i), i);
+  }
+}
+
+TEST(DisjointSets, unite) {
+  DisjointSets sets(6);
+  int r = sets.unite(0, 1);
+  EXPECT_TRUE((r == 0) || (r == 1));
+  EXPECT_EQ(sets.find(0), sets.find(1));
+  sets.unite(2, 3);
+  sets.unite(3, 4);
+  EXPECT_EQ(sets.find(2), sets.find(4));
+  EXPECT_NE(sets.find(0), sets.find(2));
+  EXPECT_EQ(sets.unite(4, 2), sets.find(3));  // already together
+  EXPECT_EQ(sets.find(5), 5);
+
+  // the larger set keeps its representative
+  int big = sets.find(2);
+  EXPECT_EQ(sets.unite(0, 4), big);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(sets.find(i), big) << i;
+  }
+}
+
+TEST(DisjointSets, reset) {
+  DisjointSets sets(3);
+  sets.unite(0, 1);
+  sets.unite(1, 2);
+  sets.reset(4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(sets.find(i), i);
+  }
+}
+
+// Random unions against labels relabelled by hand
+TEST(DisjointSets, random_unions) {
+  const int n = 200;
+  std::mt19937 rng(1);
+  DisjointSets sets(n);
+  std::vector<int> label(n);
+  for (int i = 0; i < n; i++) label[i] = i;
+  for (int step = 0; step < 300; step++) {
+    int a = rng() % n, b = rng() % n;
+    sets.unite(a, b);
+    int from = label[b], to = label[a];
+    for (auto& l : label) {
+      if (l == from) l = to;
+    }
+    int i = rng() % n, j = rng() % n;
+    ASSERT_EQ(sets.find(i) == sets.find(j), label[i] == label[j]);
+  }
+}
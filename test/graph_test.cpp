@@ -0,0 +1,113 @@
+#include "graph.h"
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Ends of each edge in a list
+std::vector<std::pair<int, int>> ends(
+    const std::list<std::shared_ptr<Edge>> &edges) {
+  std::vector<std::pair<int, int>> e;
+  for (const auto &edge : edges) {
+    e.push_back({edge->getHead(), edge->getTail()});
+  }
+  return e;
+}
+
+// Triangle 0-1-2 and vertex 3 on its own
+Graph triangle() {
+  Graph G;
+  for (int i = 0; i < 4; i++) {
+    G.addVertex(i, i + 1);
+  }
+  G.addEdge(0, 1, 1);
+  G.addEdge(1, 2, 2);
+  G.addEdge(2, 0, 3);
+  return G;
+}
+
+// The lists of the old API hold what the arrays do, in the same order
+TEST(Graph, lists) {
+  Graph G = triangle();
+  const std::list<int> &vertices = G.getVertices();
+  EXPECT_EQ(std::vector<int>(vertices.begin(), vertices.end()),
+            G.getVertexIds());
+  const std::list<std::shared_ptr<Edge>> &edges = G.getEdges();
+  EXPECT_EQ(std::vector<std::shared_ptr<Edge>>(edges.begin(), edges.end()),
+            G.getEdgePtrs());
+
+  using Ends = std::vector<std::pair<int, int>>;
+  EXPECT_EQ(ends(G.getVertex(0)->getIncEdges()), Ends({{0, 1}, {2, 0}}));
+  EXPECT_EQ(ends(G.getVertex(1)->getIncEdges()), Ends({{0, 1}, {1, 2}}));
+  EXPECT_TRUE(G.getVertex(3)->getIncEdges().empty());
+}
+
+// Lists already made follow later changes
+TEST(Graph, lists_follow_changes) {
+  Graph G = triangle();
+  const std::list<int> &vertices = G.getVertices();
+  const std::list<std::shared_ptr<Edge>> &edges = G.getEdges();
+  const auto &inc0 = G.getVertex(0)->getIncEdges();
+  const auto &inc3 = G.getVertex(3)->getIncEdges();
+
+  G.addVertex(4);
+  G.addEdge(3, 0, 4);
+  using Ends = std::vector<std::pair<int, int>>;
+  EXPECT_EQ(vertices, std::list<int>({0, 1, 2, 3, 4}));
+  EXPECT_EQ(edges.size(), 4u);
+  EXPECT_EQ(ends(inc0), Ends({{0, 1}, {2, 0}, {3, 0}}));
+  EXPECT_EQ(ends(inc3), Ends({{3, 0}}));
+
+  G.deleteVertex(1);
+  EXPECT_EQ(vertices, std::list<int>({0, 2, 3, 4}));
+  EXPECT_EQ(ends(edges), Ends({{2, 0}, {3, 0}}));
+  EXPECT_EQ(ends(inc0), Ends({{2, 0}, {3, 0}}));
+  EXPECT_EQ(ends(G.getVertex(2)->getIncEdges()), Ends({{2, 0}}));
+}
+
+// A copy lists its own edges
+TEST(Graph, copy) {
+  Graph G = triangle();
+  G.getVertex(0)->getIncEdges();
+  Graph H(G);
+  const auto &inc = H.getVertex(0)->getIncEdges();
+  ASSERT_EQ(inc.size(), 2u);
+  EXPECT_EQ(inc.front(), H.getEdgePtrs()[0]);
+  EXPECT_NE(inc.front(), G.getEdgePtrs()[0]);
+}
+
+// A Euclidean graph lists the edges it makes
+TEST(Graph, euclidean_lists) {
+  Graph G;
+  for (int i = 0; i < 3; i++) {
+    G.addVertex(i);
+  }
+  G.setCoordinates({0, 3, 0}, {0, 0, 4});
+  const auto &inc = G.getVertex(2)->getIncEdges();
+  ASSERT_EQ(inc.size(), 4u);  // two edges and the loop twice
+  EXPECT_DOUBLE_EQ(inc.front()->getWeight(), 4);
+  EXPECT_EQ(G.getEdges().size(), 6u);
+}
+
+// The edges of a Euclidean graph asked for one at a time match their records,
+// and are the ones later listed with all the others
+TEST(Graph, euclidean_edge_on_demand) {
+  Graph G;
+  for (int i = 0; i < 3; i++) {
+    G.addVertex(i);
+  }
+  G.setCoordinates({0, 3, 0}, {0, 0, 4});
+  const auto &records = G.getEdgeRecords();
+  ASSERT_EQ(records.size(), 6u);
+  std::shared_ptr<Edge> e = G.getEdgePtr(3);
+  EXPECT_EQ(e->getHead(), G.getVertexIds()[records[3].head]);
+  EXPECT_EQ(e->getTail(), G.getVertexIds()[records[3].tail]);
+  EXPECT_DOUBLE_EQ(e->getWeight(), records[3].weight);
+  EXPECT_EQ(G.getEdgePtr(3), e);
+  EXPECT_EQ(G.getEdgePtrs()[3], e);
+  for (size_t k = 0; k < records.size(); k++) {
+    EXPECT_DOUBLE_EQ(G.getEdgePtrs()[k]->getWeight(), records[k].weight);
+  }
+}
@@ -0,0 +1,124 @@
+#include "graph_view.h"
+
+#include <climits>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Graph on n vertices with m random edges of weights 1 to 4, so many are
+// tied, and some parallel edges and loops
+Graph randomGraph(int n, int m, unsigned seed) {
+  std::mt19937 rng(seed);
+  Graph G;
+  for (int i = 0; i < n; i++) {
+    G.addVertex(i, 1);
+  }
+  for (int k = 0; k < m; k++) {
+    G.addEdge(rng() % n, rng() % n, 1 + rng() % 4);
+  }
+  return G;
+}
+
+// Complete graph on n vertices with weights 1 to 4
+Graph completeGraph(int n, unsigned seed) {
+  std::mt19937 rng(seed);
+  Graph G;
+  for (int i = 0; i < n; i++) {
+    G.addVertex(i, 1);
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      G.addEdge(i, j, 1 + rng() % 4);
+    }
+  }
+  return G;
+}
+
+// Every other vertex of G, from the last one down
+std::list<int> someVertices(const Graph &G) {
+  std::list<int> S;
+  for (int v : G.getVertexIds()) {
+    if (v % 2 == 0) S.push_front(v);
+  }
+  return S;
+}
+
+// Prim's algorithm as the dense scan does it, from the first position and
+// taking the first vertex with the least key, over all the edges of H in
+// order, so the first of tied edges at a vertex is kept
+std::list<std::shared_ptr<Edge>> referenceMST(const GraphView &H) {
+  const std::vector<int> &ids = H.getVertexIds();
+  size_t n = ids.size();
+  std::map<int, int> position;
+  for (size_t v = 0; v < n; v++) position[ids[v]] = v;
+  std::vector<double> key(n, INT_MAX);
+  std::vector<char> in_tree(n, false);
+  std::vector<std::shared_ptr<Edge>> tree_edge(n);
+  std::list<std::shared_ptr<Edge>> tree;
+  if (n > 0) key[0] = 0;
+  for (size_t added = 0; added < n; added++) {
+    int u = -1;
+    for (size_t v = 0; v < n; v++) {
+      if (!in_tree[v] && (u < 0 || key[v] < key[u])) u = v;
+    }
+    in_tree[u] = true;
+    if (tree_edge[u] != nullptr) tree.push_back(tree_edge[u]);
+    for (const auto &e : H.getEdgePtrs()) {
+      int head = position[e->getHead()], tail = position[e->getTail()];
+      if (head == tail || (head != u && tail != u)) continue;
+      int v = head == u ? tail : head;
+      if (e->getWeight() < key[v]) {
+        key[v] = e->getWeight();
+        tree_edge[v] = e;
+      }
+    }
+  }
+  return tree;
+}
+
+// Checks the MST of H is the reference tree, edge for edge
+void expectReferenceMST(const GraphView &H) {
+  std::list<std::shared_ptr<Edge>> tree, expected = referenceMST(H);
+  double weight = H.MST(tree);
+  double expected_weight = 0;
+  for (const auto &e : expected) expected_weight += e->getWeight();
+  EXPECT_EQ(weight, expected_weight);
+  EXPECT_EQ(std::vector<std::shared_ptr<Edge>>(tree.begin(), tree.end()),
+            std::vector<std::shared_ptr<Edge>>(expected.begin(),
+                                               expected.end()));
+}
+
+// Sparse graphs, whole and in part, take the heap
+TEST(GraphView, sparse_mst) {
+  for (unsigned seed = 0; seed < 20; seed++) {
+    for (int m : {40, 80, 160}) {
+      Graph G = randomGraph(60, m, seed);
+      expectReferenceMST(G);
+      GraphView H(G, someVertices(G));
+      expectReferenceMST(H);
+    }
+  }
+}
+
+// Dense graphs, whole and in part, take the scan
+TEST(GraphView, dense_mst) {
+  for (unsigned seed = 0; seed < 20; seed++) {
+    Graph G = completeGraph(40, seed);
+    expectReferenceMST(G);
+    GraphView H(G, someVertices(G));
+    expectReferenceMST(H);
+    GraphView K(H, someVertices(G));
+    expectReferenceMST(K);
+  }
+}
+
+// A view of a few vertices of a large graph, with ties among its edges
+TEST(GraphView, small_view_mst) {
+  Graph G = completeGraph(300, 1);
+  GraphView H(G, std::list<int>{250, 3, 77, 120, 4, 299});
+  expectReferenceMST(H);
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "graph.h"
+#include "grow_subsets.h"
+
+// Complete graph with random integer weights and prizes, which gives both
+// distinct and tied events
+Graph randomGraph(int n, unsigned seed) {
+  std::mt19937 rng(seed);
+  Graph G;
+  for (int i = 0; i < n; i++) {
+    G.addVertex(i, 1 + rng() % 3);
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      G.addEdge(i, j, 1 + rng() % 20);
+    }
+  }
+  return G;
+}
+
+// Checks two laminar families are made of the same subsets merged over the
+// same edges, and with the same duals if they were grown at the same lambda
+void expectSameFamily(const std::list<std::shared_ptr<Subset>>& a,
+                      const std::list<std::shared_ptr<Subset>>& b,
+                      bool same_lambda) {
+  ASSERT_EQ(a.size(), b.size());
+  std::vector<std::pair<Subset*, Subset*>> stack;
+  for (auto s = a.begin(), t = b.begin(); s != a.end(); s++, t++) {
+    stack.push_back({s->get(), t->get()});
+  }
+  while (!stack.empty()) {
+    Subset *s = stack.back().first, *t = stack.back().second;
+    stack.pop_back();
+    ASSERT_EQ(s->getParent1() == nullptr, t->getParent1() == nullptr);
+    std::vector<int> vs(s->getVertices().begin(), s->getVertices().end());
+    std::vector<int> vt(t->getVertices().begin(), t->getVertices().end());
+    ASSERT_EQ(vs, vt);
+    EXPECT_EQ(s->getActive(), t->getActive());
+    EXPECT_EQ(s->getTied(), t->getTied());
+    if (same_lambda) {
+      EXPECT_NEAR(s->getY(), t->getY(), 1e-9 * (1 + std::abs(s->getY())));
+    }
+    if (s->getParent1() != nullptr) {
+      EXPECT_EQ(s->getEdge()->getHead(), t->getEdge()->getHead());
+      EXPECT_EQ(s->getEdge()->getTail(), t->getEdge()->getTail());
+      ASSERT_EQ(s->getAltEdge() == nullptr, t->getAltEdge() == nullptr);
+      stack.push_back({s->getParent1(), t->getParent1()});
+      stack.push_back({s->getParent2(), t->getParent2()});
+    }
+  }
+}
+
+// Lambdas spread over the initial range of findLR, from one edge going tight
+// to every edge going tight
+std::vector<double> lambdas(const GraphView& G) {
+  double min_w = INT_MAX, max_w = 0;
+  for (const auto& e : G.getEdgePtrs()) {
+    min_w = std::min(min_w, e->getWeight());
+    max_w = std::max(max_w, e->getWeight());
+  }
+  double l = 1 / (2 * max_w), r = G.getPrize() / min_w + 1;
+  std::vector<double> p;
+  for (int k = 0; k <= 8; k++) {
+    p.push_back(l * std::pow(r / l, k / 8.));
+  }
+  return p;
+}
+
+// The events of a build hold at the lambda it ran at, and the whole build is
+// the same wherever the log covers
+TEST(GrowthLog, ranges) {
+  for (unsigned seed = 1; seed <= 3; seed++) {
+    Graph G = randomGraph(15, seed);
+    std::vector<double> p = lambdas(G);
+    for (double lambda : p) {
+      GrowthLog log;
+      GrowSubsets g;
+      auto logged = g.build(G, lambda, &log, p.front(), p.back());
+      EXPECT_EQ(log.prefix(lambda), log.events.size());
+      for (const auto& e : log.events) {
+        EXPECT_LE(e.lo, lambda);
+        EXPECT_GE(e.hi, lambda);
+      }
+      for (size_t k = 1; k < log.events.size(); k++) {
+        EXPECT_LE(log.events[k - 1].lo, log.events[k].lo);
+        EXPECT_GE(log.events[k - 1].hi, log.events[k].hi);
+      }
+      if (!log.covers(lambda)) continue;
+      for (double other : p) {
+        if (!log.covers(other)) continue;
+        GrowSubsets fresh;
+        expectSameFamily(fresh.build(G, other), logged, other == lambda);
+      }
+    }
+  }
+}
+
+// Replaying the log of a build at one lambda gives the family of a fresh
+// build at another
+TEST(GrowthLog, replay) {
+  for (unsigned seed = 1; seed <= 3; seed++) {
+    Graph G = randomGraph(15, seed);
+    std::vector<double> p = lambdas(G);
+    for (double from : p) {
+      GrowthLog recorded;
+      GrowSubsets(SolverOptions()).build(G, from, &recorded, p.front(),
+                                         p.back());
+      for (double to : p) {
+        GrowthLog log = recorded;
+        size_t replayed = log.prefix(to);
+        auto warm = GrowSubsets().build(G, to, &log, p.front(), p.back());
+        auto cold = GrowSubsets().build(G, to);
+        expectSameFamily(warm, cold, true);
+
+        // the replayed events are kept in the new log
+        ASSERT_GE(log.events.size(), replayed);
+        for (size_t k = 0; k < replayed; k++) {
+          EXPECT_EQ(log.events[k].neutral_set,
+                    recorded.events[k].neutral_set);
+          EXPECT_EQ(log.events[k].alt_edge, recorded.events[k].alt_edge);
+        }
+      }
+    }
+  }
+}
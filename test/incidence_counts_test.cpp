@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "incidence_counts.h"
+
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Random laminar family over the vertices 0..n-1, merged in random pairs until
+// one subset is left. Returns every subset, the root last, which keeps the
+// parents of the merged subsets alive.
+std::vector<std::shared_ptr<Subset>> randomFamily(int n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<std::shared_ptr<Subset>> all, roots;
+  for (int v = 0; v < n; v++) {
+    roots.push_back(std::make_shared<Subset>(v, 0.0));
+    all.push_back(roots.back());
+  }
+  while (roots.size() > 1) {
+    int i = rng() % roots.size();
+    auto p1 = roots[i];
+    roots.erase(roots.begin() + i);
+    int j = rng() % roots.size();
+    auto p2 = roots[j];
+    roots.erase(roots.begin() + j);
+    auto e = std::make_shared<Edge>(p1->getVertices().front(),
+                                    p2->getVertices().front(), 1.0);
+    roots.push_back(std::make_shared<Subset>(p1, p2, e));
+    all.push_back(roots.back());
+  }
+  return all;
+}
+
+// Number of ends of edges in p by looking at each
+int countEnds(const std::shared_ptr<Subset>& p,
+              const std::list<std::shared_ptr<Edge>>& edges) {
+  int ends = 0;
+  for (const auto& e : edges) {
+    for (int v : p->getVertices()) {
+      ends += int(v == e->getHead()) + int(v == e->getTail());
+    }
+  }
+  return ends;
+}
+
+TEST(IncidenceCounts, counts) {
+  auto family = randomFamily(6, 1);
+  const auto& root = family.back();
+  std::list<std::shared_ptr<Edge>> edges = {
+      std::make_shared<Edge>(0, 1, 1.0), std::make_shared<Edge>(1, 5, 1.0),
+      std::make_shared<Edge>(2, 9, 1.0)};  // 9 is not in the component
+  IncidenceCounts counts(root.get(), edges);
+  EXPECT_EQ(counts.count(root.get()), 5);
+  for (const auto& p : family) {
+    EXPECT_EQ(counts.count(p.get()), countEnds(p, edges));
+    EXPECT_EQ(counts.count(*p), countEnds(p, edges));
+    for (const auto& e : edges) {
+      EXPECT_EQ(counts.ends(p.get(), e), countEnds(p, {e}));
+    }
+  }
+  EXPECT_TRUE(counts.contains(root.get(), 3));
+  EXPECT_FALSE(counts.contains(root.get(), 9));
+  EXPECT_TRUE(counts.contains(family[4].get(), 4));
+  EXPECT_FALSE(counts.contains(family[4].get(), 3));
+}
+
+// Random additions and removals against counting by hand
+TEST(IncidenceCounts, add_and_remove) {
+  const int n = 40;
+  std::mt19937 rng(2);
+  auto family = randomFamily(n, 3);
+  std::list<std::shared_ptr<Edge>> edges;
+  IncidenceCounts counts(family.back().get(), edges);
+  for (int step = 0; step < 200; step++) {
+    if (edges.empty() || (rng() % 3 != 0)) {
+      edges.push_back(std::make_shared<Edge>(rng() % n, rng() % n, 1.0));
+      counts.add(edges.back());
+    } else {
+      auto it = edges.begin();
+      std::advance(it, rng() % edges.size());
+      counts.remove(*it);
+      edges.erase(it);
+    }
+    const auto& p = family[rng() % family.size()];
+    ASSERT_EQ(counts.count(p.get()), countEnds(p, edges));
+  }
+
+  // a copy counts the same and changes on its own
+  IncidenceCounts copy(counts);
+  copy.add(std::make_shared<Edge>(0, 1, 1.0));
+  const Subset* root = family.back().get();
+  EXPECT_EQ(copy.count(root), counts.count(root) + 2);
+}
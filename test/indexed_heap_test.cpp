@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include "indexed_heap.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Pops every id, checking the keys come out in order
+static std::vector<int> drain(IndexedMinHeap<double>& heap) {
+  std::vector<int> ids;
+  double last = -1;
+  while (!heap.empty()) {
+    EXPECT_LE(last, heap.topKey());
+    last = heap.topKey();
+    ids.push_back(heap.top());
+    heap.pop();
+  }
+  return ids;
+}
+
+TEST(IndexedMinHeap, set_and_pop) {
+  IndexedMinHeap<double> heap;
+  heap.set(3, 3.0);
+  heap.set(1, 1.0);
+  heap.set(7, 2.0);
+  EXPECT_EQ(heap.size(), 3);
+  EXPECT_TRUE(heap.contains(7));
+  EXPECT_FALSE(heap.contains(2));
+  EXPECT_FALSE(heap.contains(100));
+  EXPECT_EQ(heap.top(), 1);
+  EXPECT_DOUBLE_EQ(heap.key(7), 2.0);
+  EXPECT_EQ(drain(heap), std::vector<int>({1, 7, 3}));
+  EXPECT_FALSE(heap.contains(1));
+}
+
+TEST(IndexedMinHeap, change_key) {
+  IndexedMinHeap<double> heap(4);
+  for (int id = 0; id < 4; id++) heap.set(id, id + 1.0);
+  heap.set(3, 0.5);  // decrease
+  heap.set(0, 9.0);  // increase
+  EXPECT_EQ(heap.size(), 4);
+  EXPECT_EQ(drain(heap), std::vector<int>({3, 1, 2, 0}));
+}
+
+TEST(IndexedMinHeap, erase) {
+  IndexedMinHeap<double> heap;
+  for (int id = 0; id < 6; id++) heap.set(id, 6.0 - id);
+  heap.erase(5);  // the top
+  heap.erase(0);  // the last
+  heap.erase(2);  // in between
+  heap.erase(2);  // not in the heap any more
+  EXPECT_FALSE(heap.contains(2));
+  EXPECT_EQ(drain(heap), std::vector<int>({4, 3, 1}));
+}
+
+TEST(IndexedMinHeap, pair_keys_break_ties) {
+  IndexedMinHeap<std::pair<double, int>> heap;
+  for (int id : {4, 2, 3}) heap.set(id, {1.0, id});
+  std::vector<int> ids;
+  while (!heap.empty()) {
+    ids.push_back(heap.top());
+    heap.pop();
+  }
+  EXPECT_EQ(ids, std::vector<int>({2, 3, 4}));
+}
+
+TEST(IndexedMinHeap, assign) {
+  IndexedMinHeap<double> heap;
+  heap.set(9, 0.0);
+  heap.assign({{5.0, 0}, {2.0, 4}, {3.0, 2}, {1.0, 12}});
+  EXPECT_FALSE(heap.contains(9));
+  EXPECT_TRUE(heap.contains(12));
+  EXPECT_EQ(drain(heap), std::vector<int>({12, 4, 2, 0}));
+}
+
+TEST(IndexedMinHeap, for_each_up_to) {
+  IndexedMinHeap<double> heap;
+  for (int id = 0; id < 20; id++) heap.set(id, (id * 7) % 20);
+  std::set<int> found;
+  heap.forEachUpTo(5.0, [&](int id) { found.insert(id); });
+  std::set<int> expected;
+  for (int id = 0; id < 20; id++) {
+    if ((id * 7) % 20 <= 5) expected.insert(id);
+  }
+  EXPECT_EQ(found, expected);
+}
+
+// Random operations against a sorted set of (key, id)
+TEST(IndexedMinHeap, random_operations) {
+  std::mt19937 rng(1);
+  IndexedMinHeap<std::pair<int, int>> heap;
+  std::set<std::pair<int, int>> reference;
+  std::vector<int> keys(50, -1);
+  for (int step = 0; step < 5000; step++) {
+    int id = rng() % 50, key = rng() % 100;
+    switch (rng() % 3) {
+      case 0:
+        if (keys[id] >= 0) reference.erase({keys[id], id});
+        keys[id] = key;
+        reference.insert({key, id});
+        heap.set(id, {key, id});
+        break;
+      case 1:
+        if (keys[id] >= 0) reference.erase({keys[id], id});
+        keys[id] = -1;
+        heap.erase(id);
+        break;
+      default:
+        if (!reference.empty()) {
+          keys[reference.begin()->second] = -1;
+          reference.erase(reference.begin());
+          heap.pop();
+        }
+    }
+    ASSERT_EQ(heap.size(), reference.size());
+    if (!reference.empty()) {
+      ASSERT_EQ(heap.topKey(), *reference.begin());
+    }
+  }
+}
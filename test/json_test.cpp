@@ -29,6 +29,28 @@ TEST(JsonTest, vertex) {
   EXPECT_TRUE(true);
 }
 
+TEST(JsonTest, graph) {
+  Graph G;
+  G.addVertex(0, 2);
+  G.addVertex(1, 3);
+  G.addVertex(2, 1);
+  G.addEdge(0, 1, 0.5);
+  G.addEdge(1, 2, 1.5);
+  nlohmann::json j = G;
+
+  std::cout << j.dump(4) << std::endl;
+
+  ASSERT_EQ(j.size(), 3u);
+  EXPECT_EQ(j[1]["prize"], 3);
+  EXPECT_EQ(j[0]["neighbors"].size(), 1u);
+  EXPECT_EQ(j[1]["neighbors"].size(), 2u);
+  EXPECT_EQ(j[1]["neighbors"][1]["tail"], 2);
+
+  // a vertex of the graph lists the same edges
+  nlohmann::json v = G.getVertex(1);
+  EXPECT_EQ(v["neighbors"], j[1]["neighbors"]);
+}
+
 TEST(JsonTest, subgraph) {
   nlohmann::json j;
   auto subset_0 = std::make_shared<Subset>(0, 1.0);  // vertices {0}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include <climits>
+#include <cmath>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "graph.h"
+#include "grow_subsets.h"
+#include "prune.h"
+
+// Complete graph with random integer weights and prizes, so many edges are
+// tied and many subsets have alt edges
+Graph randomGraph(int n, unsigned seed) {
+  std::mt19937 rng(seed);
+  Graph G;
+  for (int i = 0; i < n; i++) {
+    G.addVertex(i, 1 + rng() % 3);
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      G.addEdge(i, j, 1 + rng() % 10);
+    }
+  }
+  return G;
+}
+
+// All subsets of the component s, sharing its family
+std::vector<std::shared_ptr<Subset>> subsetsOf(
+    const std::shared_ptr<Subset>& s) {
+  std::vector<std::shared_ptr<Subset>> all = {s};
+  for (size_t i = 0; i < all.size(); i++) {
+    if (all[i]->getParent1() == nullptr) continue;
+    all.push_back(std::shared_ptr<Subset>(s, all[i]->getParent1()));
+    all.push_back(std::shared_ptr<Subset>(s, all[i]->getParent2()));
+  }
+  return all;
+}
+
+// Random sequences of edge swaps and subsets marked inactive on built
+// families keep the weight the same as reverseDelete from scratch
+TEST(IncrementalPrune, random_changes) {
+  int checked = 0;
+  for (unsigned seed = 1; seed <= 10; seed++) {
+    Graph G = randomGraph(25, seed);
+    std::mt19937 rng(seed);
+    for (double lambda : {0.1, 0.3, 1.0, 3.0}) {
+      GrowSubsets g;
+      for (auto s : g.build(G, lambda)) {
+        std::vector<std::shared_ptr<Subset>> all = subsetsOf(s);
+        if (all.size() == 1) continue;
+        std::vector<std::shared_ptr<Subset>> alt;
+        for (const auto& t : all) {
+          if (t->getAltEdge() != nullptr) alt.push_back(t);
+        }
+
+        IncrementalPrune pruned(s);
+        EXPECT_DOUBLE_EQ(pruned.weight(), reverseDelete(s));
+        for (int step = 0; step < 30; step++) {
+          double w;
+          if (!alt.empty() && rng() % 2 == 0) {
+            w = pruned.swapEdges(alt[rng() % alt.size()]);
+          } else {
+            w = pruned.setInactive(all[rng() % all.size()]);
+          }
+          EXPECT_EQ(w, pruned.weight());
+          ASSERT_DOUBLE_EQ(w, reverseDelete(s))
+              << "seed " << seed << " lambda " << lambda << " step " << step;
+          checked++;
+        }
+      }
+    }
+  }
+  EXPECT_GT(checked, 0);
+}
@@ -0,0 +1,54 @@
+#include "shortest_paths.h"
+
+#include "graph.h"
+#include "gtest/gtest.h"
+
+// Path 0-1-2-3 of unit edges with longer shortcuts, and vertex 4 on its own
+Graph pathGraph() {
+  Graph G;
+  for (int i = 0; i < 5; i++) {
+    G.addVertex(i);
+  }
+  G.addEdge(0, 3, 10);
+  G.addEdge(0, 1, 1);
+  G.addEdge(2, 0, 5);
+  G.addEdge(1, 2, 1);
+  G.addEdge(2, 3, 1);
+  return G;
+}
+
+TEST(ShortestPaths, distance) {
+  Graph G = pathGraph();
+  ShortestPaths paths(G);
+  EXPECT_DOUBLE_EQ(paths.distance(0, 0), 0);
+  EXPECT_DOUBLE_EQ(paths.distance(0, 1), 1);
+  EXPECT_DOUBLE_EQ(paths.distance(0, 3), 3);
+  EXPECT_DOUBLE_EQ(paths.distance(0, 2), 2);
+  EXPECT_DOUBLE_EQ(paths.distance(3, 0), 3);
+  EXPECT_DOUBLE_EQ(paths.distance(1, 4), INT_MAX);
+  EXPECT_DOUBLE_EQ(shortestPath(G, 3, 0), 3);
+}
+
+TEST(ShortestPaths, closure) {
+  Graph G = pathGraph();
+  ShortestPaths paths(G), all(G);
+  all.closure(2);
+  EXPECT_TRUE(all.hasClosure());
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      EXPECT_DOUBLE_EQ(all.distance(i, j), paths.distance(i, j));
+    }
+  }
+  EXPECT_DOUBLE_EQ(getTourLength(all, {0, 3, 1}), 3 + 2 + 1);
+  EXPECT_DOUBLE_EQ(getTourLength(G, {0, 3, 1}), 3 + 2 + 1);
+}
+
+TEST(ShortestPaths, euclidean) {
+  Graph G;
+  for (int i = 0; i < 4; i++) {
+    G.addVertex(i);
+  }
+  G.setCoordinates({0, 3, 3, 0}, {0, 0, 4, 4});
+  EXPECT_DOUBLE_EQ(getTourLength(G, {0, 1, 2, 3}), 14);
+  EXPECT_DOUBLE_EQ(getTourLength(G, {0, 2, 1, 3}), 18);
+}
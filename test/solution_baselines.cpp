@@ -1,8 +1,18 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "graph.h"
 #include "pd.h"
 #include "read_file.h"
+#include "grow_subsets.h"
 #include "subset.h"
 
 // Defines global kBaselineDatabase
@@ -17,12 +27,320 @@ TEST(SolutionBaselines, baseline_database) {
 
     // Now solve the problem
     solveInstance(info);
-    ASSERT_TRUE(info.solution.solved);
+    ASSERT_TRUE(info.solution.solved) << kv.first;
 
     // Upper bound should not increase
     ASSERT_LE(info.solution.upper_bound - kv.second.solution.upper_bound,
-              0.001);
+              0.001)
+        << kv.first;
     // Prize should not decrease
-    ASSERT_GE(info.solution.prize - kv.second.solution.prize, -0.001);
+    ASSERT_GE(info.solution.prize - kv.second.solution.prize, -0.001)
+        << kv.first;
+  }
+}
+
+// Small instances of the baseline database, with and without ties, on which
+// the solver variants are compared with the reference implementation
+const std::vector<std::string> kVariantInstances = {
+    "burma14.tsp", "ulysses22.tsp", "att48.tsp",  "berlin52.tsp",
+    "eil76.tsp",   "gr96.tsp",      "kroA100.tsp", "ch130.tsp"};
+
+// Loads a problem of the baseline database with options
+void loadVariantProblem(const std::string& name, const SolverOptions& options,
+                        Problem& problem) {
+  ASSERT_TRUE(loadProblem("tsplib_benchmarks/" + name, problem)) << name;
+  problem.budget = kBaselineDatabase.at(name).problem.budget;
+  problem.time_limit = 300;
+  problem.options = options;
+}
+
+// Solution of the reference implementation, solved once per instance
+const SolverInfo& referenceSolution(const std::string& name) {
+  static std::map<std::string, SolverInfo> solutions;
+  auto it = solutions.find(name);
+  if (it == solutions.end()) {
+    SolverInfo info;
+    loadVariantProblem(name, SolverOptions(), info.problem);
+    solveInstance(info);
+    it = solutions.emplace(name, info).first;
+  }
+  return it->second;
+}
+
+void expectSameEdge(const std::shared_ptr<Edge>& a,
+                    const std::shared_ptr<Edge>& b, const std::string& where) {
+  ASSERT_EQ(a == nullptr, b == nullptr) << where;
+  if (a == nullptr) return;
+  EXPECT_EQ(a->getHead(), b->getHead()) << where;
+  EXPECT_EQ(a->getTail(), b->getTail()) << where;
+  EXPECT_EQ(a->getWeight(), b->getWeight()) << where;
+}
+
+// Checks two laminar families are made of the same subsets, merged over the
+// same edges. Duals are summed in a different order by some engines.
+void expectSameFamily(const std::shared_ptr<Subset>& a,
+                      const std::shared_ptr<Subset>& b,
+                      const std::string& where) {
+  std::vector<std::pair<Subset*, Subset*>> stack = {{a.get(), b.get()}};
+  while (!stack.empty()) {
+    Subset *s = stack.back().first, *t = stack.back().second;
+    stack.pop_back();
+    ASSERT_EQ(s->getParent1() == nullptr, t->getParent1() == nullptr) << where;
+    std::vector<int> vs(s->getVertices().begin(), s->getVertices().end());
+    std::vector<int> vt(t->getVertices().begin(), t->getVertices().end());
+    ASSERT_EQ(vs, vt) << where;
+    EXPECT_EQ(s->getActive(), t->getActive()) << where;
+    EXPECT_EQ(s->getTied(), t->getTied()) << where;
+    EXPECT_EQ(s->getPrize(), t->getPrize()) << where;
+    EXPECT_NEAR(s->getPotential(), t->getPotential(),
+                1e-9 * (1 + std::abs(s->getPotential())))
+        << where;
+    EXPECT_NEAR(s->getY(), t->getY(), 1e-9 * (1 + std::abs(s->getY())))
+        << where;
+    if (s->getParent1() != nullptr) {
+      expectSameEdge(s->getEdge(), t->getEdge(), where);
+      expectSameEdge(s->getAltEdge(), t->getAltEdge(), where);
+      stack.push_back({s->getParent1(), t->getParent1()});
+      stack.push_back({s->getParent2(), t->getParent2()});
+    }
+  }
+}
+
+// Checks a solver variant grows the same laminar families as the reference
+// implementation at lambdas across the search range of an instance
+void expectSameFamilies(const std::string& name, const SolverOptions& options) {
+  Problem problem;
+  loadVariantProblem(name, options, problem);
+  const Graph& G = problem.graph;
+  double l, r;
+  findLR(G, problem.budget, l, r);
+  for (double f : {0.1, 0.3, 0.5, 0.7, 0.9}) {
+    double lambda = l * std::pow(r / l, f);
+    std::string where = name + " at " + std::to_string(lambda);
+    GrowSubsets reference, variant(options);
+    std::list<std::shared_ptr<Subset>> expected = reference.build(G, lambda);
+    std::list<std::shared_ptr<Subset>> family = variant.build(G, lambda);
+    ASSERT_EQ(family.size(), expected.size()) << where;
+    for (auto s = family.begin(), t = expected.begin(); s != family.end();
+         ++s, ++t) {
+      expectSameFamily(*s, *t, where);
+    }
+  }
+}
+
+// Checks a solver variant finds the same tree as the reference implementation
+// in the same number of recursions
+void expectSameSolution(const std::string& name, const SolverOptions& options) {
+  const SolverInfo& expected = referenceSolution(name);
+  SolverInfo info;
+  loadVariantProblem(name, options, info.problem);
+  solveInstance(info);
+  ASSERT_EQ(info.solution.solved, expected.solution.solved) << name;
+  EXPECT_EQ(info.solution.prize, expected.solution.prize) << name;
+  EXPECT_DOUBLE_EQ(info.solution.upper_bound, expected.solution.upper_bound)
+      << name;
+  EXPECT_DOUBLE_EQ(info.lambda, expected.lambda) << name;
+  EXPECT_EQ(info.recursions, expected.recursions) << name;
+  ASSERT_EQ(info.solution.path.size(), expected.solution.path.size()) << name;
+  auto e = expected.solution.path.begin();
+  for (const auto& edge : info.solution.path) {
+    expectSameEdge(edge, *e++, name);
+  }
+}
+
+// Every instance of the baseline database, in order of name
+std::vector<std::string> databaseInstances() {
+  std::vector<std::string> names;
+  for (const auto& kv : kBaselineDatabase) {
+    names.push_back(kv.first);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+// Options whose results must be those of the reference implementation, checked
+// on the small instances with every test run
+class SolverVariants : public ::testing::TestWithParam<SolverOptions> {};
+
+TEST_P(SolverVariants, same_families) {
+  for (const auto& name : kVariantInstances) {
+    expectSameFamilies(name, GetParam());
+  }
+}
+
+TEST_P(SolverVariants, same_solutions) {
+  for (const auto& name : kVariantInstances) {
+    expectSameSolution(name, GetParam());
+  }
+}
+
+// The same checks on the whole database, where the larger instances reach the
+// fast paths and fallbacks of the variants. Run by their own test target.
+class SolverVariantsFullDatabase : public SolverVariants {};
+
+TEST_P(SolverVariantsFullDatabase, same_families) {
+  for (const auto& name : databaseInstances()) {
+    expectSameFamilies(name, GetParam());
+  }
+}
+
+TEST_P(SolverVariantsFullDatabase, same_solutions) {
+  for (const auto& name : databaseInstances()) {
+    expectSameSolution(name, GetParam());
+  }
+}
+
+SolverOptions variantOptions(std::function<void(SolverOptions&)> set) {
+  SolverOptions options;
+  set(options);
+  return options;
+}
+
+const SolverOptions kEventQueueEngine =
+    variantOptions([](SolverOptions& o) {
+      o.growth_engine = GrowthEngine::kEventQueue;
+    });
+INSTANTIATE_TEST_CASE_P(event_queue_engine, SolverVariants,
+                        ::testing::Values(kEventQueueEngine));
+INSTANTIATE_TEST_CASE_P(event_queue_engine, SolverVariantsFullDatabase,
+                        ::testing::Values(kEventQueueEngine));
+
+const SolverOptions kLazyEdgeScanEngine =
+    variantOptions([](SolverOptions& o) {
+      o.growth_engine = GrowthEngine::kLazyEdgeScan;
+    });
+INSTANTIATE_TEST_CASE_P(lazy_edge_scan_engine, SolverVariants,
+                        ::testing::Values(kLazyEdgeScanEngine));
+INSTANTIATE_TEST_CASE_P(lazy_edge_scan_engine, SolverVariantsFullDatabase,
+                        ::testing::Values(kLazyEdgeScanEngine));
+
+const SolverOptions kVectorEdgeScanEngine =
+    variantOptions([](SolverOptions& o) {
+      o.growth_engine = GrowthEngine::kVectorEdgeScan;
+    });
+INSTANTIATE_TEST_CASE_P(vector_edge_scan_engine, SolverVariants,
+                        ::testing::Values(kVectorEdgeScanEngine));
+INSTANTIATE_TEST_CASE_P(vector_edge_scan_engine, SolverVariantsFullDatabase,
+                        ::testing::Values(kVectorEdgeScanEngine));
+
+const SolverOptions kParallelVectorEdgeScanEngine =
+    variantOptions([](SolverOptions& o) {
+      o.growth_engine = GrowthEngine::kVectorEdgeScan;
+      o.num_threads = 4;
+    });
+INSTANTIATE_TEST_CASE_P(parallel_vector_edge_scan_engine, SolverVariants,
+                        ::testing::Values(kParallelVectorEdgeScanEngine));
+INSTANTIATE_TEST_CASE_P(parallel_vector_edge_scan_engine,
+                        SolverVariantsFullDatabase,
+                        ::testing::Values(kParallelVectorEdgeScanEngine));
+
+const SolverOptions kContractedEdgeScanEngine =
+    variantOptions([](SolverOptions& o) {
+      o.growth_engine = GrowthEngine::kContractedEdgeScan;
+    });
+INSTANTIATE_TEST_CASE_P(contracted_edge_scan_engine, SolverVariants,
+                        ::testing::Values(kContractedEdgeScanEngine));
+INSTANTIATE_TEST_CASE_P(contracted_edge_scan_engine, SolverVariantsFullDatabase,
+                        ::testing::Values(kContractedEdgeScanEngine));
+
+const SolverOptions kParallelLambdaSearch =
+    variantOptions([](SolverOptions& o) {
+      o.lambda_probes = 4;
+    });
+INSTANTIATE_TEST_CASE_P(parallel_lambda_search, SolverVariants,
+                        ::testing::Values(kParallelLambdaSearch));
+INSTANTIATE_TEST_CASE_P(parallel_lambda_search, SolverVariantsFullDatabase,
+                        ::testing::Values(kParallelLambdaSearch));
+
+const SolverOptions kWarmStartedLambdaSearch =
+    variantOptions([](SolverOptions& o) {
+      o.warm_start_probes = true;
+    });
+INSTANTIATE_TEST_CASE_P(warm_started_lambda_search, SolverVariants,
+                        ::testing::Values(kWarmStartedLambdaSearch));
+INSTANTIATE_TEST_CASE_P(warm_started_lambda_search, SolverVariantsFullDatabase,
+                        ::testing::Values(kWarmStartedLambdaSearch));
+
+const SolverOptions kParametricLambdaSearch =
+    variantOptions([](SolverOptions& o) {
+      o.parametric_lambda_search = true;
+    });
+INSTANTIATE_TEST_CASE_P(parametric_lambda_search, SolverVariants,
+                        ::testing::Values(kParametricLambdaSearch));
+INSTANTIATE_TEST_CASE_P(parametric_lambda_search, SolverVariantsFullDatabase,
+                        ::testing::Values(kParametricLambdaSearch));
+
+const SolverOptions kParallelRecursion =
+    variantOptions([](SolverOptions& o) {
+      o.recursion_threads = 4;
+    });
+INSTANTIATE_TEST_CASE_P(parallel_recursion, SolverVariants,
+                        ::testing::Values(kParallelRecursion));
+INSTANTIATE_TEST_CASE_P(parallel_recursion, SolverVariantsFullDatabase,
+                        ::testing::Values(kParallelRecursion));
+
+const SolverOptions kCachedSubproblems =
+    variantOptions([](SolverOptions& o) {
+      o.cache_subproblems = true;
+    });
+INSTANTIATE_TEST_CASE_P(cached_subproblems, SolverVariants,
+                        ::testing::Values(kCachedSubproblems));
+INSTANTIATE_TEST_CASE_P(cached_subproblems, SolverVariantsFullDatabase,
+                        ::testing::Values(kCachedSubproblems));
+
+const SolverOptions kNearestNeighborEdgeScan =
+    variantOptions([](SolverOptions& o) {
+      o.nearest_neighbors = 5;
+    });
+INSTANTIATE_TEST_CASE_P(nearest_neighbor_edge_scan, SolverVariants,
+                        ::testing::Values(kNearestNeighborEdgeScan));
+INSTANTIATE_TEST_CASE_P(nearest_neighbor_edge_scan, SolverVariantsFullDatabase,
+                        ::testing::Values(kNearestNeighborEdgeScan));
+
+// The tour built after PD stays within the budget, and keeps the vertices of
+// the tree if PD found one rather than a forest
+TEST(SolutionBaselines, improved_tour) {
+  for (const auto& kv : kBaselineDatabase) {
+    SolverInfo info;
+    ASSERT_TRUE(loadProblem("tsplib_benchmarks/" + kv.first, info.problem));
+    if (info.problem.graph.getVertexIds().size() > 200) continue;
+    info.problem.budget = kv.second.problem.budget;
+    info.problem.time_limit = 300;
+    info.problem.options.improve_tour = true;
+
+    solveInstance(info);
+    ASSERT_TRUE(info.solution.solved) << kv.first;
+    ASSERT_LE(info.solution.tour_length, info.problem.budget + 0.001)
+        << kv.first;
+    std::set<int> vertices;
+    for (const auto& e : info.solution.path) {
+      vertices.insert(e->getHead());
+      vertices.insert(e->getTail());
+    }
+    if (vertices.size() == info.solution.path.size() + 1) {
+      ASSERT_GE(info.solution.tour_prize, info.solution.prize) << kv.first;
+    }
+  }
+}
+
+// The recursion on several threads writes the same progress as on one
+TEST(SolutionBaselines, parallel_recursion_progress) {
+  for (const std::string& name : kVariantInstances) {
+    std::vector<std::string> progress;
+    for (int threads : {1, 4}) {
+      Problem problem;
+      loadVariantProblem(name, SolverOptions(), problem);
+      problem.options.recursion_threads = threads;
+      std::list<std::shared_ptr<Edge>> edges;
+      double upper, lambda;
+      int recursions;
+      bool found;
+      std::ostringstream out;
+      PD(problem.graph, problem.budget, edges, upper, recursions, lambda,
+         found, true, problem.time_limit, problem.options, nullptr, nullptr,
+         out);
+      progress.push_back(out.str());
+    }
+    EXPECT_EQ(progress[0], progress[1]) << name;
   }
 }
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "pd.h"
+
+// Adds a complete graph with random integer weights and prizes to G
+void addRandomGraph(Graph& G, int n, unsigned seed) {
+  std::mt19937 rng(seed);
+  for (int i = 0; i < n; i++) {
+    G.addVertex(i, 1 + rng() % 5);
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      G.addEdge(i, j, 1 + rng() % 50);
+    }
+  }
+}
+
+// Problem on the random graph of seed, solved with the subproblem cache
+SolverInfo cachedProblem(unsigned seed, double budget) {
+  SolverInfo info;
+  addRandomGraph(info.problem.graph, 30, seed);
+  info.problem.budget = budget;
+  info.problem.time_limit = 1000;
+  info.problem.options.cache_subproblems = true;
+  return info;
+}
+
+void expectSamePath(const std::list<std::shared_ptr<Edge>>& a,
+                    const std::list<std::shared_ptr<Edge>>& b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (auto e = a.begin(), f = b.begin(); e != a.end(); e++, f++) {
+    EXPECT_EQ((*e)->getHead(), (*f)->getHead());
+    EXPECT_EQ((*e)->getTail(), (*f)->getTail());
+  }
+}
+
+TEST(SubproblemCacheTest, find_and_insert) {
+  SubproblemCache cache;
+  SubproblemResult result{{}, 7, 9.5, 3, 0.25, true};
+  cache.insert({2, 0, 1}, 10, result);
+
+  SubproblemResult found;
+  ASSERT_TRUE(cache.find({2, 0, 1}, 10, &found));
+  EXPECT_EQ(found.prize, 7);
+  EXPECT_EQ(found.upper, 9.5);
+  EXPECT_EQ(found.recursions, 3);
+  EXPECT_FALSE(cache.find({2, 0, 1}, 11, &found));  // other budget
+  EXPECT_FALSE(cache.find({0, 1, 2}, 10, &found));  // other order
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 2);
+}
+
+// A second solve of the same graph with the cache of the first finds each
+// subproblem the first one solved, and comes out the same
+TEST(SubproblemCacheTest, solve_again) {
+  int reached = 0;
+  for (unsigned seed = 0; seed < 20; seed++) {
+    for (double budget : {40.0, 80.0, 160.0}) {
+      SubproblemCache cache;
+      SolverInfo first = cachedProblem(seed, budget);
+      solveInstance(first, &cache);
+      SolverInfo second = cachedProblem(seed, budget);
+      solveInstance(second, &cache);
+
+      EXPECT_EQ(first.solution.solved, second.solution.solved);
+      EXPECT_EQ(first.solution.prize, second.solution.prize);
+      EXPECT_EQ(first.solution.upper_bound, second.solution.upper_bound);
+      EXPECT_EQ(first.lambda, second.lambda);
+      EXPECT_EQ(first.recursions, second.recursions);
+      expectSamePath(first.solution.path, second.solution.path);
+
+      // Only subproblems at the top of the recursion are looked up again
+      EXPECT_EQ(second.cache_misses, 0);
+      EXPECT_LE(second.cache_hits, first.cache_misses);
+      if (first.recursions > 1) {
+        EXPECT_GT(second.cache_hits, 0);
+        reached++;
+      }
+    }
+  }
+  EXPECT_GT(reached, 0);  // some solves recursed
+}
+
+// A solve without the cache comes out the same as one with it
+TEST(SubproblemCacheTest, same_as_uncached) {
+  for (unsigned seed = 0; seed < 10; seed++) {
+    SubproblemCache cache;
+    SolverInfo warm = cachedProblem(seed, 80);
+    solveInstance(warm, &cache);
+    solveInstance(warm, &cache);
+    SolverInfo plain = cachedProblem(seed, 80);
+    plain.problem.options.cache_subproblems = false;
+    solveInstance(plain);
+
+    EXPECT_EQ(plain.cache_hits, 0);
+    EXPECT_EQ(warm.solution.prize, plain.solution.prize);
+    EXPECT_EQ(warm.solution.upper_bound, plain.solution.upper_bound);
+    EXPECT_EQ(warm.recursions, plain.recursions);
+    expectSamePath(warm.solution.path, plain.solution.path);
+  }
+}
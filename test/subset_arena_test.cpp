@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "subset_arena.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+TEST(SubsetArena, numbers_subsets) {
+  SubsetArena arena;
+  EXPECT_EQ(arena.size(), 0);
+  auto a = arena.make(3, 1.5);
+  auto b = arena.make(5, 2.0, 4);
+  auto e = std::make_shared<Edge>(3, 5, 1.0);
+  Subset* ab = arena.make(a, b, e);
+  EXPECT_EQ(arena.size(), 3);
+  EXPECT_EQ(a->getId(), 0);
+  EXPECT_EQ(b->getId(), 1);
+  EXPECT_EQ(ab->getId(), 2);
+
+  // the constructor arguments are passed through
+  EXPECT_DOUBLE_EQ(a->getPotential(), 1.5);
+  EXPECT_EQ(b->getPrize(), 4);
+  EXPECT_EQ(ab->getParent1(), a);
+  EXPECT_EQ(ab->getEdge(), e);
+  std::vector<int> vertices(ab->getVertices().begin(),
+                            ab->getVertices().end());
+  EXPECT_EQ(vertices, std::vector<int>({3, 5}));
+}
+
+// A family larger than a block, with every subset aligned
+TEST(SubsetArena, many_subsets) {
+  SubsetArena arena;
+  std::vector<Subset*> subsets;
+  for (int v = 0; v < 5000; v++) {
+    subsets.push_back(arena.make(v, 0.0));
+  }
+  for (int v = 0; v < 5000; v++) {
+    EXPECT_EQ(subsets[v]->getId(), v);
+    EXPECT_EQ(arena.get(v), subsets[v]);
+    EXPECT_EQ(subsets[v]->getVertices().front(), v);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(subsets[v]) % alignof(Subset), 0u);
+  }
+}
+
+// A shared subset keeps its family valid after the arena that made it is gone
+TEST(SubsetArena, outlives_arena) {
+  std::shared_ptr<Subset> root;
+  {
+    SubsetArena arena;
+    Subset* s = arena.make(0, 0.0);
+    for (int v = 1; v < 100; v++) {
+      s = arena.make(s, arena.make(v, 0.0),
+                     std::make_shared<Edge>(v - 1, v, 1.0));
+    }
+    root = arena.share(s);
+  }
+  EXPECT_EQ(root->getId(), 198);
+  int expected = 0;
+  for (int v : root->getVertices()) {
+    EXPECT_EQ(v, expected++);
+  }
+  EXPECT_EQ(expected, 100);
+  EXPECT_EQ(root->getParent2()->getVertices().front(), 99);
+}
+
+// Subsets shared from one family hold it together, and it is destroyed with
+// the last of them
+TEST(SubsetArena, shares_family) {
+  auto edge = std::make_shared<Edge>(0, 1, 1.0);
+  std::weak_ptr<Edge> alive = edge;
+  std::shared_ptr<Subset> parent;
+  {
+    SubsetArena arena;
+    Subset* a = arena.make(0, 0.0);
+    Subset* ab = arena.make(a, arena.make(1, 0.0), edge);
+    std::shared_ptr<Subset> root = arena.share(ab);
+    parent = arena.share(a);
+    EXPECT_EQ(root.use_count(), parent.use_count());
+  }
+  edge.reset();
+  EXPECT_FALSE(alive.expired());  // still held by the merged subset
+  EXPECT_EQ(parent->getVertices().front(), 0);
+  parent.reset();
+  EXPECT_TRUE(alive.expired());
+}
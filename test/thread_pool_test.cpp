@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPool, runs_every_task_once) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+  for (int num_tasks : {0, 1, 3, 100}) {
+    std::vector<std::atomic<int>> runs(num_tasks);
+    for (auto& r : runs) r = 0;
+    pool.run(num_tasks, [&](int i) { runs[i]++; });
+    for (int i = 0; i < num_tasks; i++) {
+      EXPECT_EQ(runs[i], 1) << i;
+    }
+  }
+}
+
+TEST(ThreadPool, single_thread) {
+  ThreadPool pool(1);
+  EXPECT_EQ(pool.size(), 1);
+  std::vector<int> order;
+  pool.run(5, [&](int i) { order.push_back(i); });
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+// Loops from several threads are served one after the other, and each returns
+// only once all of its own tasks are done
+TEST(ThreadPool, concurrent_callers) {
+  ThreadPool pool(3);
+  std::vector<int> sums(4);
+  std::vector<std::thread> callers;
+  for (int c = 0; c < 4; c++) {
+    callers.emplace_back([&, c] {
+      std::atomic<int> sum(0);
+      pool.run(50, [&](int i) { sum += i; });
+      sums[c] = sum;
+    });
+  }
+  for (auto& t : callers) t.join();
+  for (int c = 0; c < 4; c++) {
+    EXPECT_EQ(sums[c], 50 * 49 / 2) << c;
+  }
+}
+
+TEST(ThreadPool, shared) {
+  ThreadPool& pool = ThreadPool::shared(2);
+  EXPECT_EQ(pool.size(), 2);
+  EXPECT_EQ(&ThreadPool::shared(2), &pool);
+  std::atomic<int> count(0);
+  pool.run(10, [&](int) { count++; });
+  EXPECT_EQ(count, 10);
+}
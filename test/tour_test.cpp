@@ -0,0 +1,103 @@
+#include "tour.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+#include "graph.h"
+#include "gtest/gtest.h"
+
+// Euclidean graph on the points (x[i], y[i]) with the given prizes
+Graph pointsGraph(const std::vector<int> &x, const std::vector<int> &y,
+                  const std::vector<int> &prizes) {
+  Graph G;
+  for (size_t i = 0; i < x.size(); i++) {
+    G.addVertex(i, prizes[i]);
+  }
+  G.setCoordinates(x, y);
+  return G;
+}
+
+// Checks tour visits the vertices of expected in its order, from any start and
+// either way round
+void expectSameCycle(std::vector<int> tour, const std::vector<int> &expected) {
+  ASSERT_EQ(tour.size(), expected.size());
+  std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), expected[0]),
+              tour.end());
+  if (tour != expected) {
+    std::reverse(tour.begin() + 1, tour.end());
+  }
+  EXPECT_EQ(tour, expected);
+}
+
+// Octagon with corners 0 to 7 in order round it, of perimeter 4 + 4 sqrt(2)
+Graph octagon() {
+  return pointsGraph({1, 2, 3, 3, 2, 1, 0, 0}, {0, 0, 1, 2, 3, 3, 2, 1},
+                     std::vector<int>(8, 1));
+}
+const double kOctagonLength = 4 + 4 * std::sqrt(2);
+
+// 2-opt takes out the crossing of the diagonals of a rectangle
+TEST(Tour, two_opt) {
+  Graph G = pointsGraph({0, 3, 3, 0}, {0, 0, 4, 4}, {1, 1, 1, 1});
+  ShortestPaths paths(G);
+  std::vector<int> tour = {0, 2, 1, 3};
+  double length = improveTour(paths, tour, getTourLength(paths, tour));
+  EXPECT_DOUBLE_EQ(length, 14);
+  EXPECT_DOUBLE_EQ(length, getTourLength(paths, tour));
+  expectSameCycle(tour, {0, 1, 2, 3});
+}
+
+// Or-opt puts a run of two corners taken to the other side of the octagon
+// back in its place
+TEST(Tour, or_opt) {
+  Graph G = octagon();
+  ShortestPaths paths(G);
+  std::vector<int> tour = {0, 1, 4, 5, 6, 2, 3, 7};
+  double length = improveTour(paths, tour, getTourLength(paths, tour));
+  EXPECT_NEAR(length, kOctagonLength, 1e-9);
+  EXPECT_NEAR(length, getTourLength(paths, tour), 1e-9);
+  expectSameCycle(tour, {0, 1, 2, 3, 4, 5, 6, 7});
+}
+
+// Vertices are added while the tour stays within the budget, and no vertex
+// left out fits in it
+TEST(Tour, insert_within_budget) {
+  // Points on a line from a tour of 0 and 1, the far ones worth more
+  Graph G = pointsGraph({0, 1, 2, 3, 5, 8, 1}, {0, 0, 0, 0, 0, 0, 1},
+                        {1, 1, 1, 2, 4, 8, 0});
+  for (double budget : {2.0, 4.0, 6.0, 10.0, 16.0, 20.0}) {
+    ShortestPaths paths(G);
+    std::vector<int> tour = {0, 1};
+    double length = insertVertices(G, paths, tour, getTourLength(paths, tour),
+                                   budget);
+    EXPECT_LE(length, budget);
+    EXPECT_NEAR(length, getTourLength(paths, tour), 1e-9);
+    EXPECT_EQ(std::count(tour.begin(), tour.end(), 6), 0);  // no prize
+
+    for (int v = 0; v < 6; v++) {
+      if (std::count(tour.begin(), tour.end(), v) > 0) continue;
+      double least = INT_MAX;
+      for (size_t k = 0; k < tour.size(); k++) {
+        int u = tour[k], w = tour[(k + 1) % tour.size()];
+        least = std::min(least, paths.distance(u, v) + paths.distance(v, w) -
+                                    paths.distance(u, w));
+      }
+      EXPECT_GT(length + least, budget) << v << " fits in " << budget;
+    }
+  }
+}
+
+// Vertices are dropped until the tour is within the budget
+TEST(Tour, drop_to_budget) {
+  Graph G = octagon();
+  for (double budget : {12.0, 8.0, 5.0, 1.0}) {
+    ShortestPaths paths(G);
+    std::vector<int> tour = {0, 1, 2, 3, 4, 5, 6, 7};
+    double length =
+        dropVertices(G, paths, tour, getTourLength(paths, tour), budget);
+    EXPECT_LE(length, budget + 1e-9);
+    EXPECT_NEAR(length, getTourLength(paths, tour), 1e-9);
+  }
+}